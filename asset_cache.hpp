@@ -0,0 +1,235 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSET_CACHE_HAS_MMAP 1
+#endif
+
+namespace my_library {
+    // Decoded RGBA images and font files packed into one file, mapped into memory on startup.
+    // Entries are checked against the size and modification time of their source file,
+    // the whole cache is rebuilt from the sources when any of them changed.
+    class AssetCache {
+        static constexpr std::array<char, 8> magic = {'S', 'T', 'Y', 'P', 'C', 'A', 'C', '1'};
+        static constexpr std::uint64_t alignment = 64;
+
+        enum class Kind : std::uint32_t { Image = 1, Font = 2, Undecodable = 3 };   // Undecodable entries only keep the stamp
+
+        struct Header {
+            std::array<char, 8> magic;
+            std::uint32_t count;
+            std::uint32_t reserved;
+        };
+
+        struct Entry {
+            std::array<char, 128> source;
+            std::uint64_t sourceSize;
+            std::int64_t sourceTime;
+            Kind kind;
+            std::uint32_t width;
+            std::uint32_t height;
+            std::uint32_t reserved;
+            std::uint64_t offset;
+            std::uint64_t length;
+        };
+
+        std::string path;
+        std::uint8_t const* data = nullptr;
+        std::size_t size = 0;
+        std::vector<std::uint8_t> buffer;   // Used instead of a mapping where mmap is not available
+
+        static auto sourceStamp(std::string const& source, std::uint64_t& sourceSize, std::int64_t& sourceTime) -> bool {
+            std::error_code error;
+            sourceSize = std::filesystem::file_size(source, error);
+            if (error) return false;
+            sourceTime = std::filesystem::last_write_time(source, error).time_since_epoch().count();
+            return !error;
+        }
+
+        static auto isImage(std::string const& source) {
+            auto extension = std::filesystem::path(source).extension().string();
+            return extension != ".ttf" && extension != ".otf";
+        }
+
+        auto header() const { return reinterpret_cast<Header const*>(data); }
+
+        auto entries() const { return reinterpret_cast<Entry const*>(data + sizeof(Header)); }
+
+        auto find(std::string const& source) const -> Entry const* {
+            if (data == nullptr) return nullptr;
+            for (std::uint32_t i = 0; i < header()->count; ++i) {
+                if (source == entries()[i].source.data())
+                    return &entries()[i];
+            }
+            return nullptr;
+        }
+
+        auto isValid(std::vector<std::string> const& sources) const -> bool {
+            if (size < sizeof(Header) || header()->magic != magic)
+                return false;
+            if (size < sizeof(Header) + header()->count * sizeof(Entry))
+                return false;
+
+            for (auto const& source : sources) {
+                if (source.size() >= sizeof(Entry::source))
+                    continue;   // Paths this long are never cached
+                auto entry = find(source);
+                std::uint64_t sourceSize;
+                std::int64_t sourceTime;
+                if (!sourceStamp(source, sourceSize, sourceTime)) {
+                    if (entry != nullptr) return false;
+                    continue;   // Missing sources are not cached, loading them falls back to the file
+                }
+                if (entry == nullptr || entry->sourceSize != sourceSize || entry->sourceTime != sourceTime || entry->offset + entry->length > size)
+                    return false;
+            }
+            return true;
+        }
+
+        auto map() -> bool {
+            unmap();
+#ifdef ASSET_CACHE_HAS_MMAP
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat info{};
+            if (fstat(fd, &info) != 0 || info.st_size == 0) {
+                close(fd);
+                return false;
+            }
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED) return false;
+            data = static_cast<std::uint8_t const*>(mapping);
+            size = static_cast<std::size_t>(info.st_size);
+#else
+            std::ifstream infile(path, std::ios::binary);
+            if (!infile) return false;
+            buffer.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+#endif
+            return true;
+        }
+
+        auto unmap() -> void {
+#ifdef ASSET_CACHE_HAS_MMAP
+            if (data != nullptr)
+                munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+            buffer.clear();
+            data = nullptr;
+            size = 0;
+        }
+
+        auto rebuild(std::vector<std::string> const& sources) -> bool {
+            std::vector<Entry> newEntries;
+            std::vector<std::vector<std::uint8_t>> blobs;
+            std::uint64_t offset = sizeof(Header) + sources.size() * sizeof(Entry);
+
+            for (auto const& source : sources) {
+                Entry entry{};
+                if (source.size() >= entry.source.size() || !sourceStamp(source, entry.sourceSize, entry.sourceTime))
+                    continue;
+                std::memcpy(entry.source.data(), source.c_str(), source.size() + 1);
+
+                std::vector<std::uint8_t> blob;
+                if (isImage(source)) {
+                    sf::Image image;
+                    if (!image.loadFromFile(source)) {
+                        entry.kind = Kind::Undecodable;     // Remembered, so the cache is not rebuilt on every launch
+                    } else {
+                        entry.kind = Kind::Image;
+                        entry.width = image.getSize().x;
+                        entry.height = image.getSize().y;
+                        blob.assign(image.getPixelsPtr(), image.getPixelsPtr() + std::size_t{entry.width} * entry.height * 4);
+                    }
+                } else {
+                    std::ifstream infile(source, std::ios::binary);
+                    entry.kind = Kind::Font;
+                    blob.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+                }
+
+                offset = (offset + alignment - 1) / alignment * alignment;
+                entry.offset = offset;
+                entry.length = blob.size();
+                offset += blob.size();
+                newEntries.push_back(entry);
+                blobs.push_back(std::move(blob));
+            }
+
+            unmap();
+            auto temporary = path + ".tmp";
+            {
+                std::ofstream outfile(temporary, std::ios::binary | std::ios::trunc);
+                Header newHeader{magic, static_cast<std::uint32_t>(newEntries.size()), 0};
+                newEntries.resize(sources.size());  // Sources without a stamp leave empty slots, blob offsets stay valid
+                outfile.write(reinterpret_cast<char const*>(&newHeader), sizeof(newHeader));
+                outfile.write(reinterpret_cast<char const*>(newEntries.data()), static_cast<std::streamsize>(newEntries.size() * sizeof(Entry)));
+
+                std::uint64_t position = sizeof(Header) + sources.size() * sizeof(Entry);
+                for (std::size_t i = 0; i < blobs.size(); ++i) {
+                    auto blobOffset = (position + alignment - 1) / alignment * alignment;
+                    std::array<char, alignment> padding{};
+                    outfile.write(padding.data(), static_cast<std::streamsize>(blobOffset - position));
+                    outfile.write(reinterpret_cast<char const*>(blobs[i].data()), static_cast<std::streamsize>(blobs[i].size()));
+                    position = blobOffset + blobs[i].size();
+                }
+                if (!outfile) return false;
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            return !error && map();
+        }
+
+    public:
+        AssetCache(std::string path, std::vector<std::string> const& sources) : path(std::move(path)) {
+            if (!map() || !isValid(sources))
+                rebuild(sources);
+        }
+
+        AssetCache(AssetCache const&) = delete;
+        auto operator=(AssetCache const&) -> AssetCache& = delete;
+        ~AssetCache() { unmap(); }
+
+        // Fall back to decoding the source file when it is not in the cache
+        auto loadTexture(std::string const& source, sf::Texture& texture) -> bool {
+            auto entry = find(source);
+            if (entry == nullptr || entry->kind != Kind::Image)
+                return texture.loadFromFile(source);
+            if (!texture.create(entry->width, entry->height))
+                return false;
+            texture.update(data + entry->offset);
+            return true;
+        }
+
+        auto loadImage(std::string const& source, sf::Image& image) -> bool {
+            auto entry = find(source);
+            if (entry == nullptr || entry->kind != Kind::Image)
+                return image.loadFromFile(source);
+            image.create(entry->width, entry->height, data + entry->offset);
+            return true;
+        }
+
+        // The font reads glyphs straight from the cache, which must outlive it
+        auto loadFont(std::string const& source, sf::Font& font) -> bool {
+            auto entry = find(source);
+            if (entry == nullptr || entry->kind != Kind::Font)
+                return font.loadFromFile(source);
+            return font.loadFromMemory(data + entry->offset, entry->length);
+        }
+    };
+}
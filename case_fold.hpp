@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CASE_FOLD_HAS_SSE2 1
+#endif
+
+// Case folding of typed input and word list words, shared by the game and fold_bench.cpp
+namespace my_library {
+    // Simple case folding of Basic Latin, Latin-1 and Latin Extended-A (covers Polish and German)
+    constexpr auto makeFoldTable() {
+        std::array<char32_t, 0x180> table{};
+        for (char32_t c = 0; c < table.size(); ++c) {
+            bool upper = (c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7);
+            bool pairEven = (c >= 0x100 && c <= 0x137 && c != 0x130) || (c >= 0x14A && c <= 0x177);
+            bool pairOdd = (c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E);
+            if (upper)
+                table[c] = c + 32;
+            else if ((pairEven && c % 2 == 0) || (pairOdd && c % 2 == 1))
+                table[c] = c + 1;
+            else
+                table[c] = c;
+        }
+        table[0x178] = 0xFF;    // Ÿ
+        table[0x17F] = 's';     // long s
+        return table;
+    }
+
+    constexpr auto foldTable = makeFoldTable();
+
+    constexpr auto foldCase(char32_t c) -> char32_t {
+        if (c < foldTable.size()) return foldTable[c];
+        if (c == 0x1E9E) return 0xDF;   // capital sharp s
+        return c;
+    }
+
+    // One table lookup per character, the reference the SSE2 path below is measured against (FoldBench)
+    inline auto foldCaseScalar(std::u32string_view str) -> std::u32string {
+        std::u32string folded(str.size(), U'\0');
+        for (std::size_t i = 0; i < str.size(); ++i)
+            folded[i] = foldCase(str[i]);
+        return folded;
+    }
+
+    // Blocks of 4 ASCII characters are folded in SSE2 registers with two compares and an or, other blocks and
+    // the tail take the lookup. Measured with FoldBench, builds without SSE2 only have the lookup.
+    inline auto foldCase(std::u32string_view str) -> std::u32string {
+#ifdef CASE_FOLD_HAS_SSE2
+        std::u32string folded(str.size(), U'\0');
+        auto const ascii = _mm_set1_epi32(0x7F);
+        auto const beforeA = _mm_set1_epi32('A' - 1);
+        auto const afterZ = _mm_set1_epi32('Z' + 1);
+        auto const caseBit = _mm_set1_epi32(0x20);
+        std::size_t i = 0;
+        for (; i + 4 <= str.size(); i += 4) {
+            auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str.data() + i));
+            if (_mm_movemask_epi8(_mm_cmpgt_epi32(block, ascii)) != 0) {
+                for (std::size_t j = 0; j < 4; ++j)
+                    folded[i + j] = foldCase(str[i + j]);
+                continue;
+            }
+            auto upper = _mm_and_si128(_mm_cmpgt_epi32(block, beforeA), _mm_cmplt_epi32(block, afterZ));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(folded.data() + i), _mm_or_si128(block, _mm_and_si128(upper, caseBit)));
+        }
+        for (; i < str.size(); ++i)
+            folded[i] = foldCase(str[i]);
+        return folded;
+#else
+        return foldCaseScalar(str);
+#endif
+    }
+}
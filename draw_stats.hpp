@@ -0,0 +1,76 @@
+#pragma once
+
+#include "glyph_cache.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdlib>
+
+namespace my_library {
+    // Draw calls and vertices submitted to the GPU, as SFML 2.6 builds them for each drawable
+    struct DrawStats {
+        std::size_t drawCalls = 0;
+        std::size_t vertices = 0;
+
+        auto add(std::size_t count) {
+            if (count == 0) return;     // SFML skips empty vertex arrays
+            drawCalls++;
+            vertices += count;
+        }
+
+        auto count(sf::Text const& text) {
+            std::size_t glyphs = 0;
+            for (auto c : text.getString())
+                glyphs += c != ' ' && c != '\t' && c != '\n';
+            if (text.getOutlineThickness() != 0)
+                add(glyphs * 6);
+            add(glyphs * 6);
+        }
+
+        auto count(sf::Shape const& shape) {
+            add(shape.getPointCount() + 2);
+            if (shape.getOutlineThickness() != 0)
+                add((shape.getPointCount() + 1) * 2);
+        }
+
+        auto count(sf::Sprite const&) { add(4); }
+
+        auto count(CachedText const& text) { add(text.getVertexCount()); }
+    };
+
+    // Render target wrapper that counts everything drawn through it
+    class CountingTarget {
+        sf::RenderTarget& target;
+        DrawStats* stats;
+
+    public:
+        CountingTarget(sf::RenderTarget& target, DrawStats* stats = nullptr) : target(target), stats(stats) { }
+
+        template<typename T>
+        auto draw(T const& drawable) {
+            target.draw(drawable);
+            if (stats != nullptr)
+                stats->count(drawable);
+        }
+    };
+
+    // Pixels of two frames with any channel further apart than the tolerance, size mismatches count as all pixels
+    inline auto countDifferentPixels(sf::Image const& frame, sf::Image const& golden, int tolerance = 2) -> std::size_t {
+        auto size = frame.getSize();
+        if (size != golden.getSize())
+            return std::size_t{size.x} * size.y;
+
+        std::size_t differing = 0;
+        auto const* a = frame.getPixelsPtr();
+        auto const* b = golden.getPixelsPtr();
+        for (std::size_t i = 0; i < std::size_t{size.x} * size.y * 4; i += 4) {
+            for (std::size_t channel = 0; channel < 4; ++channel) {
+                if (std::abs(a[i + channel] - b[i + channel]) > tolerance) {
+                    differing++;
+                    break;
+                }
+            }
+        }
+        return differing;
+    }
+}
@@ -0,0 +1,74 @@
+// Times the per-character and the SSE2 case folding of case_fold.hpp on the built-in words.
+// FoldBench [rounds] folds every word one by one, as the game does, and all words joined into one string,
+// where the SSE2 blocks cover nearly everything, and prints ns per character for both paths.
+#include "case_fold.hpp"
+#include "words.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace {
+    // Keeps the folding from being optimized away
+    volatile std::size_t sink;
+
+    template<typename Fold>
+    auto nsPerCharacter(Fold fold, std::vector<std::u32string> const& inputs, std::size_t rounds) {
+        std::size_t characters = 0;
+        std::size_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (auto const& input : inputs) {
+                auto folded = fold(input);
+                characters += folded.size();
+                checksum += folded.empty() ? 0 : folded.back();
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        sink = checksum;
+        return elapsed.count() / static_cast<double>(std::max<std::size_t>(characters, 1));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t rounds = 20000;
+    if (argc > 2 || (argc == 2 && (rounds = std::strtoul(argv[1], nullptr, 10)) == 0)) {
+        fmt::println(std::cerr, "usage: {} [rounds]", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::u32string> samples;
+    for (auto const& word : builtInWords)
+        samples.emplace_back(word.text.begin(), word.text.end());
+    // Upper-case copies, so folding has work to do
+    for (std::size_t i = 0, count = samples.size(); i < count; ++i) {
+        auto upper = samples[i];
+        for (auto& c : upper)
+            c = c >= U'a' && c <= U'z' ? c - 32 : c;
+        samples.push_back(std::move(upper));
+    }
+    std::vector<std::u32string> joined(1);
+    for (auto const& sample : samples)
+        joined.front() += sample;
+
+    auto differs = [](std::u32string const& sample) { return my_library::foldCaseScalar(sample) != my_library::foldCase(sample); };
+    if (std::ranges::any_of(samples, differs) || std::ranges::any_of(joined, differs)) {
+        fmt::println(std::cerr, "SSE2 and scalar case folding differ");
+        return 1;
+    }
+
+    auto scalar = [](std::u32string_view str) { return my_library::foldCaseScalar(str); };
+    auto sse2 = [](std::u32string_view str) { return my_library::foldCase(str); };
+
+    fmt::println("words: {}  rounds: {}", samples.size(), rounds);
+    fmt::println("one by one   scalar {:.3f} ns/char  sse2 {:.3f} ns/char",
+                 nsPerCharacter(scalar, samples, rounds), nsPerCharacter(sse2, samples, rounds));
+    fmt::println("joined       scalar {:.3f} ns/char  sse2 {:.3f} ns/char",
+                 nsPerCharacter(scalar, joined, rounds), nsPerCharacter(sse2, joined, rounds));
+    return 0;
+}
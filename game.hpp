@@ -0,0 +1,36 @@
+#pragma once
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <fmt/ostream.h>
+
+inline auto& scoresFile() {
+    static auto file = std::fstream("../assets/scores.txt", std::ios::out | std::ios::app);
+    return file;
+}
+
+struct Game {
+    std::string nickname;
+    int score;
+    int wpm;
+    int speed;
+    int maxFreq;
+    float time;
+    std::string date;
+
+    Game(std::string nickname, int const& score, int const& wpm, int const& speed, int const& maxFreq, float const& time, std::string date)
+    : nickname(std::move(nickname)), score(score), wpm(wpm), speed(speed), maxFreq(maxFreq), time(time), date(std::move(date))  { };
+
+    auto saveScoreToFile(std::ostream& out = scoresFile()) {
+        fmt::print(out, "{} ", nickname);
+        fmt::print(out, "{} ", score);
+        fmt::print(out, "{} ", wpm);
+        fmt::print(out, "{} ", speed);
+        fmt::print(out, "{} ", maxFreq);
+        fmt::print(out, "{} ", time);
+        fmt::println(out, "{}", date);
+        out.flush();
+    }
+};
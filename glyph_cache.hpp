@@ -0,0 +1,148 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace my_library {
+    // Laid-out glyph quads of one string, in pixels relative to the text origin, as sf::Text builds them
+    struct GlyphGeometry {
+        std::vector<sf::Vertex> vertices;
+        sf::FloatRect bounds;
+    };
+
+    // Geometry shared by every text with the same string, font, character size and color,
+    // so respawning a word or switching its color never lays the glyphs out again
+    class GlyphCache {
+        struct Key {
+            std::u32string string;
+            sf::Font const* font;
+            unsigned size;
+            sf::Uint32 color;
+
+            auto operator==(Key const&) const -> bool = default;
+        };
+
+        struct KeyHash {
+            auto operator()(Key const& key) const -> std::size_t {
+                auto hash = std::hash<std::u32string>()(key.string);
+                hash ^= std::hash<sf::Font const*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                hash ^= (static_cast<std::size_t>(key.size) << 32 | key.color) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                return hash;
+            }
+        };
+
+        std::unordered_map<Key, GlyphGeometry, KeyHash> geometries;   // Node based, references stay valid
+
+        static auto build(std::u32string const& string, sf::Font const& font, unsigned size, sf::Color color) {
+            GlyphGeometry geometry;
+            geometry.vertices.reserve(string.size() * 6);
+
+            float x = 0;
+            float y = static_cast<float>(size);
+            float minX = static_cast<float>(size);
+            float minY = static_cast<float>(size);
+            float maxX = 0;
+            float maxY = 0;
+            char32_t previous = 0;
+
+            for (char32_t current : string) {
+                x += font.getKerning(previous, current, size);
+                previous = current;
+
+                auto const& glyph = font.getGlyph(current, size, false);
+                float padding = 1.0f;
+                float left = glyph.bounds.left - padding;
+                float top = glyph.bounds.top - padding;
+                float right = glyph.bounds.left + glyph.bounds.width + padding;
+                float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+                float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+                float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+                float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+                float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+                auto& vertices = geometry.vertices;
+                vertices.emplace_back(sf::Vector2f(x + left, y + top), color, sf::Vector2f(u1, v1));
+                vertices.emplace_back(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1));
+                vertices.emplace_back(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2));
+                vertices.emplace_back(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2));
+                vertices.emplace_back(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1));
+                vertices.emplace_back(sf::Vector2f(x + right, y + bottom), color, sf::Vector2f(u2, v2));
+
+                minX = std::min(minX, x + glyph.bounds.left);
+                maxX = std::max(maxX, x + glyph.bounds.left + glyph.bounds.width);
+                minY = std::min(minY, y + glyph.bounds.top);
+                maxY = std::max(maxY, y + glyph.bounds.top + glyph.bounds.height);
+                x += glyph.advance;
+            }
+
+            if (!string.empty())
+                geometry.bounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+            return geometry;
+        }
+
+    public:
+        static auto shared() -> GlyphCache& {
+            static GlyphCache cache;
+            return cache;
+        }
+
+        auto get(std::u32string const& string, sf::Font const& font, unsigned size, sf::Color color) -> GlyphGeometry const& {
+            Key key{string, &font, size, color.toInteger()};
+            auto iter = geometries.find(key);
+            if (iter == geometries.end())
+                iter = geometries.emplace(std::move(key), build(string, font, size, color)).first;
+            return iter->second;
+        }
+    };
+
+    // Drop-in for the part of sf::Text the words use, drawing is one translated draw call of cached geometry
+    class CachedText : public sf::Drawable, public sf::Transformable {
+        std::u32string string;
+        sf::Font const* font;
+        unsigned size;
+        sf::Color color = sf::Color::White;
+        GlyphGeometry const* geometry;
+
+        auto update() {
+            geometry = &GlyphCache::shared().get(string, *font, size, color);
+        }
+
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+            if (geometry->vertices.empty()) return;
+            states.transform *= getTransform();
+            states.texture = &font->getTexture(size);
+            target.draw(geometry->vertices.data(), geometry->vertices.size(), sf::Triangles, states);
+        }
+
+    public:
+        CachedText(std::u32string string, sf::Font const& font, unsigned size)
+        : string(std::move(string)), font(&font), size(size) {
+            update();
+        }
+
+        auto setFont(sf::Font const& newFont) {
+            if (font == &newFont) return;
+            font = &newFont;
+            update();
+        }
+
+        auto setFillColor(sf::Color const& newColor) {
+            if (color == newColor) return;
+            color = newColor;
+            update();
+        }
+
+        auto getString() const -> std::u32string const& { return string; }
+
+        auto getVertexCount() const { return geometry->vertices.size(); }
+
+        auto getLocalBounds() const { return geometry->bounds; }
+
+        auto getGlobalBounds() const { return getTransform().transformRect(geometry->bounds); }
+    };
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "game.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace my_library {
+    // All stored games ordered by score (ties keep the order they were played in).
+    // A treap with subtree sizes: inserting, ranking a score and selecting the n-th game are O(log n).
+    class Leaderboard {
+        static constexpr std::int32_t none = -1;
+
+        struct Node {
+            Game game;
+            std::uint64_t order;        // Insertion number, breaks ties between equal scores
+            std::uint32_t priority;
+            std::uint32_t size = 1;
+            std::int32_t left = none;
+            std::int32_t right = none;
+        };
+
+        std::vector<Node> nodes;        // Children are indices, so the tree never allocates per node
+        std::int32_t root = none;
+        std::uint64_t random = 0x9e3779b97f4a7c15ULL;
+
+        auto sizeOf(std::int32_t node) const -> std::uint32_t { return node == none ? 0 : nodes[node].size; }
+
+        auto update(std::int32_t node) {
+            nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+        }
+
+        auto before(Node const& a, Node const& b) const {
+            return a.game.score != b.game.score ? a.game.score > b.game.score : a.order < b.order;
+        }
+
+        // Splits the tree into the nodes ordered before key and the rest
+        auto split(std::int32_t node, Node const& key, std::int32_t& left, std::int32_t& right) -> void {
+            if (node == none) {
+                left = right = none;
+            } else if (before(nodes[node], key)) {
+                split(nodes[node].right, key, nodes[node].right, right);
+                left = node;
+                update(node);
+            } else {
+                split(nodes[node].left, key, left, nodes[node].left);
+                right = node;
+                update(node);
+            }
+        }
+
+        auto merge(std::int32_t left, std::int32_t right) -> std::int32_t {
+            if (left == none) return right;
+            if (right == none) return left;
+            if (nodes[left].priority > nodes[right].priority) {
+                nodes[left].right = merge(nodes[left].right, right);
+                update(left);
+                return left;
+            }
+            nodes[right].left = merge(left, nodes[right].left);
+            update(right);
+            return right;
+        }
+
+        auto nextPriority() {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            return static_cast<std::uint32_t>(random >> 32);
+        }
+
+    public:
+        auto insert(Game game) {
+            auto node = static_cast<std::int32_t>(nodes.size());
+            nodes.push_back({std::move(game), nodes.size(), nextPriority()});
+            std::int32_t left;
+            std::int32_t right;
+            split(root, nodes[node], left, right);
+            root = merge(merge(left, node), right);
+        }
+
+        auto size() const -> std::size_t { return nodes.size(); }
+
+        // Place a game with this score takes, 1 is the best, ties share the better place
+        auto rank(int score) const -> std::size_t {
+            std::size_t better = 0;
+            for (auto node = root; node != none; ) {
+                if (nodes[node].game.score > score) {
+                    better += sizeOf(nodes[node].left) + 1;
+                    node = nodes[node].right;
+                } else {
+                    node = nodes[node].left;
+                }
+            }
+            return better + 1;
+        }
+
+        // Share of all games placed at or above this rank, in percent
+        auto percentile(std::size_t place) const -> float {
+            return nodes.empty() ? 0 : static_cast<float>(place) / static_cast<float>(nodes.size()) * 100;
+        }
+
+        // Game at the given place, counted from 1
+        auto at(std::size_t place) const -> Game const& {
+            auto index = static_cast<std::uint32_t>(place - 1);
+            auto node = root;
+            while (true) {
+                auto leftSize = sizeOf(nodes[node].left);
+                if (index < leftSize) {
+                    node = nodes[node].left;
+                } else if (index == leftSize) {
+                    return nodes[node].game;
+                } else {
+                    index -= leftSize + 1;
+                    node = nodes[node].right;
+                }
+            }
+        }
+
+        // Up to count games from the given place on
+        auto page(std::size_t first, std::size_t count) const {
+            std::vector<Game> games;
+            for (auto place = std::max<std::size_t>(first, 1); place < first + count && place <= nodes.size(); ++place)
+                games.push_back(at(place));
+            return games;
+        }
+    };
+
+    // Reads the first bytes of a scores file, games saved later are inserted as they are played
+    inline auto loadLeaderboard(std::string const& path, std::uintmax_t bytes) {
+        Leaderboard leaderboard;
+        std::ifstream infile(path);
+        std::string line;
+        std::uintmax_t read = 0;
+
+        while (read < bytes && std::getline(infile, line)) {
+            read += line.size() + 1;
+            std::istringstream iss(line);
+            std::string nickname, date;
+            int score, wpm, speed, maxFreq;
+            float time;
+
+            if (iss >> nickname >> score >> wpm >> speed >> maxFreq >> time >> date)
+                leaderboard.insert(Game(nickname, score, wpm, speed, maxFreq, time, date));
+        }
+        return leaderboard;
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define LIVE_STATS_HAS_SHM 1
+#endif
+
+// Live stats of a running game in POSIX shared memory (/stantyper-<pid>), read by stats_reader.cpp.
+// The block has a fixed layout and is guarded by a seqlock: the game never waits for readers,
+// readers retry when they raced with a write.
+namespace live_stats {
+    constexpr std::uint32_t magic = 0x53544c53;     // "STLS"
+    constexpr std::uint32_t version = 1;
+
+    // Same order as Screen in main.cpp
+    constexpr std::array<std::string_view, 5> gameStateNames = {"Starting", "Options", "Game", "GameOver", "Score"};
+
+    struct Snapshot {
+        std::uint32_t gameState = 0;
+        std::int32_t score = 0;
+        std::int32_t wpm = 0;
+        std::int32_t missedCount = 0;
+        std::int32_t wordsFinished = 0;
+        float frameMs = 0;
+        float inputLatencyMs = 0;   // From polling a key until the frame showing it was displayed
+        std::uint64_t frame = 0;
+    };
+
+    struct Block {
+        std::uint32_t magic;
+        std::uint32_t version;
+        alignas(64) std::atomic<std::uint32_t> sequence;    // Odd while a write is in progress
+        std::atomic<std::uint32_t> gameState;
+        std::atomic<std::int32_t> score;
+        std::atomic<std::int32_t> wpm;
+        std::atomic<std::int32_t> missedCount;
+        std::atomic<std::int32_t> wordsFinished;
+        std::atomic<float> frameMs;
+        std::atomic<float> inputLatencyMs;
+        std::atomic<std::uint64_t> frame;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<float>::is_always_lock_free,
+                  "The block is shared between processes, its atomics must not use locks");
+
+    inline auto blockName(long pid) { return "/stantyper-" + std::to_string(pid); }
+
+    // Only the game writes, publish is a handful of relaxed stores and two sequence stores
+    class Writer {
+        Block* block = nullptr;
+        std::string name;
+
+    public:
+        Writer() {
+#ifdef LIVE_STATS_HAS_SHM
+            name = blockName(static_cast<long>(getpid()));
+            int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+            if (fd < 0) return;
+            if (ftruncate(fd, sizeof(Block)) != 0) {
+                close(fd);
+                shm_unlink(name.c_str());
+                return;
+            }
+            void* mapping = mmap(nullptr, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED) {
+                shm_unlink(name.c_str());
+                return;
+            }
+            block = static_cast<Block*>(mapping);
+            block->magic = magic;
+            block->version = version;
+#endif
+        }
+
+        Writer(Writer const&) = delete;
+        auto operator=(Writer const&) -> Writer& = delete;
+
+        ~Writer() {
+#ifdef LIVE_STATS_HAS_SHM
+            if (block == nullptr) return;
+            munmap(block, sizeof(Block));
+            shm_unlink(name.c_str());
+#endif
+        }
+
+        auto publish(Snapshot const& snapshot) {
+            if (block == nullptr) return;
+            auto sequence = block->sequence.load(std::memory_order_relaxed);
+            block->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            block->gameState.store(snapshot.gameState, std::memory_order_relaxed);
+            block->score.store(snapshot.score, std::memory_order_relaxed);
+            block->wpm.store(snapshot.wpm, std::memory_order_relaxed);
+            block->missedCount.store(snapshot.missedCount, std::memory_order_relaxed);
+            block->wordsFinished.store(snapshot.wordsFinished, std::memory_order_relaxed);
+            block->frameMs.store(snapshot.frameMs, std::memory_order_relaxed);
+            block->inputLatencyMs.store(snapshot.inputLatencyMs, std::memory_order_relaxed);
+            block->frame.store(snapshot.frame, std::memory_order_relaxed);
+
+            block->sequence.store(sequence + 2, std::memory_order_release);
+        }
+    };
+
+    // Consistent copy of the block, empty when the writer kept changing it
+    inline auto read(Block const& block, int attempts = 1000) -> std::optional<Snapshot> {
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            auto before = block.sequence.load(std::memory_order_acquire);
+            if (before % 2 != 0) continue;
+
+            Snapshot snapshot;
+            snapshot.gameState = block.gameState.load(std::memory_order_relaxed);
+            snapshot.score = block.score.load(std::memory_order_relaxed);
+            snapshot.wpm = block.wpm.load(std::memory_order_relaxed);
+            snapshot.missedCount = block.missedCount.load(std::memory_order_relaxed);
+            snapshot.wordsFinished = block.wordsFinished.load(std::memory_order_relaxed);
+            snapshot.frameMs = block.frameMs.load(std::memory_order_relaxed);
+            snapshot.inputLatencyMs = block.inputLatencyMs.load(std::memory_order_relaxed);
+            snapshot.frame = block.frame.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (block.sequence.load(std::memory_order_relaxed) == before)
+                return snapshot;
+        }
+        return std::nullopt;
+    }
+}
@@ -1,8 +1,8 @@
 #include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
 #include <utility>
 #include <vector>
 #include <ctime>
-#include <random>
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
@@ -11,33 +11,25 @@
 #include <string>
 #include <iostream>
 #include <fmt/format.h>
-#include <queue>
-
-auto scoresFile = std::fstream("../assets/scores.txt", std::ios::out | std::ios::app);
-
-struct Game {
-    std::string nickname;
-    int score;
-    int wpm;
-    int speed;
-    int maxFreq;
-    float time;
-    std::string date;
-
-    Game(std::string nickname, int const& score, int const& wpm, int const& speed, int const& maxFreq, float const& time, std::string date)
-    : nickname(std::move(nickname)), score(score), wpm(wpm), speed(speed), maxFreq(maxFreq), time(time), date(std::move(date))  { };
-
-    auto saveScoreToFile() {
-        fmt::print(scoresFile, "{} ", nickname);
-        fmt::print(scoresFile, "{} ", score);
-        fmt::print(scoresFile, "{} ", wpm);
-        fmt::print(scoresFile, "{} ", speed);
-        fmt::print(scoresFile, "{} ", maxFreq);
-        fmt::print(scoresFile, "{} ", time);
-        fmt::println(scoresFile, "{}", date);
-        scoresFile.flush();
-    }
-};
+#include <numeric>
+#include <future>
+#include <chrono>
+#include <array>
+#include <string_view>
+#include <map>
+#include <optional>
+#include <tuple>
+#include "game.hpp"
+#include "race.hpp"
+#include "asset_cache.hpp"
+#include "telemetry.hpp"
+#include "glyph_cache.hpp"
+#include "draw_stats.hpp"
+#include "words.hpp"
+#include "leaderboard.hpp"
+#include "live_stats.hpp"
+#include "rng.hpp"
+#include "case_fold.hpp"
 
 enum class Screen {
     Starting,
@@ -47,29 +39,52 @@ enum class Screen {
     Score,
 };
 
+namespace my_library {
+    auto toUtf32(sf::String const& str) {
+        auto utf32 = str.toUtf32();
+        return std::u32string(utf32.begin(), utf32.end());
+    }
+
+    auto toSfString(std::u32string const& str) {
+        return sf::String::fromUtf32(str.begin(), str.end());
+    }
+
+    // Word list file in UTF-8, words separated by whitespace
+    auto loadWordList(std::string const& path) {
+        std::ifstream infile(path);
+        std::vector<sf::String> words;
+        std::string word;
+
+        while (infile >> word) {
+            if (words.empty() && word.starts_with("\xEF\xBB\xBF"))
+                word.erase(0, 3);
+            words.push_back(sf::String::fromUtf8(word.begin(), word.end()));
+        }
+        return words;
+    }
+}
+
 struct Word {
-    sf::Text text;
+    my_library::CachedText text;
+    std::u32string_view key;    // Case-folded text, in the built-in table or in the folded word list
+    std::uint32_t hash;         // wordHash(key)
+    int builtIn = -1;           // Index in builtInWords, -1 for words from a word list
     bool isFinished;
 
-    Word(std::string const &str, sf::Font const &font, int const &fontSize)
-            : text(str, font, fontSize), isFinished(true) {
+    Word(sf::String const &str, std::u32string_view key, sf::Font const &font, int const &fontSize)
+            : text(my_library::toUtf32(str), font, fontSize), key(key), hash(wordHash(key)), isFinished(true) {
         text.setFillColor(sf::Color::White);
     }
-};
 
-namespace my_library {
-    auto equalsIgnoreCase(std::string const &left, std::string const &right) -> bool {
-        if (left.size() != right.size()) return false;
-        return std::equal(left.begin(), left.end(), right.begin(), right.end(),
-                          [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+    // Built-in words come with their folded key and hash precomputed
+    Word(BuiltInWord const& word, sf::Font const &font, int const &fontSize)
+            : text(std::u32string(word.text.begin(), word.text.end()), font, fontSize), key(word.wideKey),
+              hash(word.hash), builtIn(word.index), isFinished(true) {
+        text.setFillColor(sf::Color::White);
     }
+};
 
-    auto getRandomInt(int from, int to) { //stackoverflow.com/questions/13445688/how-to-generate-a-random-number-in-c
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(from, to);
-        return dis(gen);
-    }
+namespace my_library {
 
     auto intersects(const Word &toCheckWord, const Word &existingWord) -> bool {
         sf::FloatRect toCheckBounds = toCheckWord.text.getGlobalBounds();
@@ -78,64 +93,85 @@ namespace my_library {
         return toCheckBounds.intersects(existingBounds);
     }
 
+    auto printFrameTimes(std::vector<float> frameTimes) {
+        std::ranges::sort(frameTimes);
+        auto at = [&](float fraction) { return frameTimes[static_cast<std::size_t>(fraction * static_cast<float>(frameTimes.size() - 1))]; };
+        auto mean = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0) / static_cast<double>(frameTimes.size());
+        fmt::println("frames: {}  mean: {:.3f} ms  p50: {:.3f} ms  p95: {:.3f} ms  p99: {:.3f} ms",
+                     frameTimes.size(), mean, at(0.5f), at(0.95f), at(0.99f));
+    }
+
     auto timeToStr(std::tm const& time) {
         std::ostringstream oss;
         oss << std::put_time(&time, "%d.%m.%Y");
         return oss.str();
     }
-
-    struct CompareScore {
-        bool operator()(const Game& a, const Game& b) {
-                 return a.score > b.score;
-        }
-    };
-
-    auto getTopScorers() {
-        std::ifstream infile("../assets/scores.txt");
-        std::priority_queue<Game, std::vector<Game>, CompareScore> pq; //en.cppreference.com/w/cpp/container/priority_queue
-        std::string line;
-
-        while (std::getline(infile, line)) {
-            std::istringstream iss(line);
-            std::string nickname, date;
-            int score, wpm, speed, maxFreq;
-            float time;
-
-            iss >> nickname >> score >> wpm >> speed >> maxFreq >> time >> date;
-            Game game(nickname, score, wpm, speed, maxFreq, time, date);
-
-            if (pq.size() < 10) {
-                pq.push(game);
-            } else if (game.score > pq.top().score) {
-                pq.pop();
-                pq.push(game);
-            }
-        }
-
-        std::vector<Game> topScorers;
-        while (!pq.empty()) {
-            topScorers.push_back(pq.top());
-            pq.pop();
-        }
-
-        std::ranges::sort(topScorers.begin(), topScorers.end(), [](const Game& a, const Game& b) {
-            return a.score > b.score;
-        });
-        std::ranges::reverse(topScorers.begin(), topScorers.end());
-        return topScorers;
-    }
 }
 
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+
+    // Command line: --race <socket path|host:port> [--session <id>] joins a race hosted by race_server,
+    // --words <file> replaces the built-in words with a UTF-8 word list,
+    // --telemetry saves the end-of-game analytics next to the scores,
+    // --autoplay <frames> plays a scripted game for that many frames and prints frame times,
+    // --bench <frames> [--density <words>] [--golden <dir>] renders a synthetic game offscreen and prints draw statistics,
+    // --seed <n> replays the word order and spawn positions of a game from its logged seed
+    std::string raceAddress;
+    std::string wordListPath;
+    std::uint32_t raceSession = 0;
+    bool saveTelemetry = false;
+    std::size_t autoplayFrames = 0;
+    std::size_t benchFrames = 0;
+    std::size_t benchDensity = 20;
+    std::string goldenDir;
+    std::optional<std::uint64_t> fixedSeed;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--race" && i + 1 < argc)
+            raceAddress = argv[++i];
+        else if (arg == "--session" && i + 1 < argc)
+            raceSession = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--words" && i + 1 < argc)
+            wordListPath = argv[++i];
+        else if (arg == "--telemetry")
+            saveTelemetry = true;
+        else if (arg == "--autoplay" && i + 1 < argc)
+            autoplayFrames = std::stoul(argv[++i]);
+        else if (arg == "--bench" && i + 1 < argc)
+            benchFrames = std::stoul(argv[++i]);
+        else if (arg == "--density" && i + 1 < argc)
+            benchDensity = std::stoul(argv[++i]);
+        else if (arg == "--golden" && i + 1 < argc)
+            goldenDir = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc)
+            fixedSeed = std::stoull(argv[++i]);
+    }
+
+    race::Client raceClient;
+    if (!raceAddress.empty() && !raceClient.connect(raceAddress))
+        fmt::println(std::cerr, "Cannot connect to race server at {}", raceAddress);
+    std::map<std::uint16_t, race::Progress> racers;
+    std::uint16_t racePlayer = 0;
+
+    // Asset cache with decoded frames and fonts, built on the first run and whenever a source file changes
+    std::vector<std::string> assetSources = {
+            "../assets/icon.jpg",
+            "../assets/fonts/arial.ttf",
+            "../assets/fonts/BROMPH_TOWN.ttf",
+            "../assets/fonts/Astonpoliz.ttf",
+            "../assets/fonts/Bubblegum.ttf",
+            "../assets/fonts/Hello_Samosa.ttf"
+    };
+    for (int i = 1; i <= 19; i++)
+        assetSources.push_back("../assets/bg_animation/frame_2." + std::to_string(i) + ".1.png");
+
+    my_library::AssetCache assetCache("../assets/assets.cache", assetSources);
 
     // Load animation frames
-    std::vector<sf::Texture> animationFrames;
-    for (int i = 1; i <= 19; i++) {
-        sf::Texture frame;
-        frame.loadFromFile("../assets/bg_animation/frame_2." + std::to_string(i) + ".1.png");
-        animationFrames.push_back(frame);
-    }
+    std::vector<sf::Texture> animationFrames(19);
+    for (int i = 1; i <= 19; i++)
+        assetCache.loadTexture("../assets/bg_animation/frame_2." + std::to_string(i) + ".1.png", animationFrames[i - 1]);
 
     // Setup sprites
     sf::Sprite animationSprite;
@@ -150,68 +186,48 @@ int main() {
 
 
 
-    // Words source
-    std::vector<std::string> wordsSource = {
-            "apple", "run", "beautiful", "he", "quickly", "and", "under", "wow", "cat", "jump",
-            "tall", "she", "very", "but", "over", "oops", "dog", "eat", "small", "they", "slowly",
-            "because", "in", "hey", "house", "swim", "smart", "we", "happily", "if", "on", "oh",
-            "tree", "walk", "strong", "you", "softly", "or", "with", "ah", "sun", "fly", "kind",
-            "it", "loudly", "while", "at", "ouch", "moon", "sit", "fast", "carefully",
-            "although", "by", "car", "read", "bright", "us", "gently", "unless", "near", "sky",
-            "write", "dark", "him", "eagerly", "since", "of", "star", "sleep", "sweet", "her",
-            "quietly", "though", "between", "ugh", "flower", "sing", "brave", "them", "silently",
-            "whether", "during", "river", "dance", "warm", "me", "yet", "before", "hooray", "grass",
-            "talk", "cold", "this", "really", "after", "behind", "hill", "play", "sharp", "that",
-            "simply", "when", "through", "hello", "bird", "listen", "soft", "mine", "until",
-            "against", "boat", "laugh", "clear", "yours", "once", "above", "fish", "study", "smooth",
-            "his", "seldom", "as", "along", "book", "climb", "funny", "weep", "clearly", "nor",
-            "beside", "chair", "dig", "hard", "whom", "eventually", "therefore", "beneath", "table",
-            "drive", "easy", "myself", "indeed", "instead", "beyond", "music", "cook", "happy",
-            "herself", "recently", "nevertheless", "inside", "window", "smile", "itself", "moreover",
-            "outside", "door", "open", "wide", "ourselves", "finally", "hence", "roof", "close",
-            "short", "anybody", "suddenly", "thus", "across", "wall", "throw", "rough", "somebody",
-            "just", "accordingly", "below", "ground", "hold", "nobody", "maybe", "also", "within",
-            "ceiling", "catch", "narrow", "sometimes", "otherwise", "without", "path", "build",
-            "thick", "everybody", "furthermore", "upon", "street", "draw", "thin", "often",
-            "meanwhile", "alongside", "road", "cut", "heavy", "immediately", "likewise", "underneath",
-            "bridge", "chase", "light", "anything", "always", "anyway", "among", "mountain", "seek",
-            "whichever", "henceforward", "forest", "lift", "themselves", "nonetheless", "throughout",
-            "ocean", "taste", "clean", "whomever", "hardly", "around", "yay"
-    };
-    std::ranges::shuffle(wordsSource, std::random_device());
+    // Words source, the built-in words unless a word list is given
+    std::vector<sf::String> wordList;
+    if (!wordListPath.empty()) {
+        wordList = my_library::loadWordList(wordListPath);
+        if (wordList.empty())
+            fmt::println(std::cerr, "Cannot load words from {}", wordListPath);
+    }
 
-    // SFML Window
-    sf::RenderWindow window(sf::VideoMode(800, 600), "StanTyper");
+    // SFML Window, the benchmark renders offscreen only and never opens it
+    const sf::Vector2u windowSize(800, 600);
+    sf::RenderWindow window;
+    if (benchFrames == 0)
+        window.create(sf::VideoMode(windowSize.x, windowSize.y), "StanTyper");
 
     // Setting icon
     sf::Image icon;
-    if (icon.loadFromFile("../assets/icon.jpg")) {
+    if (assetCache.loadImage("../assets/icon.jpg", icon)) {
         window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
     }
 
     // Game variables
     bool scoreSaved = false;
     bool scoreDownloaded = false;
-    std::vector<Game> topScorers;
     Screen gameState = Screen::Starting;
     Screen previousGameState = gameState;
     std::string nickname;
 
     // Load fonts
     sf::Font arialFont;
-    arialFont.loadFromFile("../assets/fonts/arial.ttf");
+    assetCache.loadFont("../assets/fonts/arial.ttf", arialFont);
 
     sf::Font interfaceFont;
-    interfaceFont.loadFromFile("../assets/fonts/BROMPH_TOWN.ttf");
+    assetCache.loadFont("../assets/fonts/BROMPH_TOWN.ttf", interfaceFont);
 
     sf::Font astonpolizFont;
-    astonpolizFont.loadFromFile("../assets/fonts/Astonpoliz.ttf");
+    assetCache.loadFont("../assets/fonts/Astonpoliz.ttf", astonpolizFont);
 
     sf::Font bubblegumFont;
-    bubblegumFont.loadFromFile("../assets/fonts/Bubblegum.ttf");
+    assetCache.loadFont("../assets/fonts/Bubblegum.ttf", bubblegumFont);
 
     sf::Font helloSamosaFont;
-    helloSamosaFont.loadFromFile("../assets/fonts/Hello_Samosa.ttf");
+    assetCache.loadFont("../assets/fonts/Hello_Samosa.ttf", helloSamosaFont);
 
     // Store fonts and font texts
     std::vector<sf::Font> fonts = {arialFont, interfaceFont, astonpolizFont, bubblegumFont, helloSamosaFont};
@@ -230,24 +246,24 @@ int main() {
     int currentFontIndex = 0;
 
     // Game Over overlay and text
-    sf::RectangleShape gameOverOverlay(sf::Vector2f(static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y)));
+    sf::RectangleShape gameOverOverlay(sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
     gameOverOverlay.setFillColor(sf::Color(0, 0, 0, 200));
 
     sf::Text gameOverText("Game Over", interfaceFont, 50);
     gameOverText.setFillColor(sf::Color::Red);
-    gameOverText.setPosition(290, static_cast<float>(window.getSize().y) / 2 - 200);
+    gameOverText.setPosition(290, static_cast<float>(windowSize.y) / 2 - 200);
 
     // Score variables
     int score = 0;
     sf::Text scoreText("Score: ", interfaceFont, 24);
-    scoreText.setPosition(370, static_cast<float>(window.getSize().y - scoreText.getCharacterSize() * 1.4));
+    scoreText.setPosition(370, static_cast<float>(windowSize.y - scoreText.getCharacterSize() * 1.4));
 
     sf::Text scoreValueText("", interfaceFont, 24);
     scoreValueText.setPosition(scoreText.getPosition().x + 5, scoreText.getPosition().y);
     scoreValueText.setFillColor(sf::Color(255, 255, 140));
 
     sf::Text wordsText("Words: ", interfaceFont, 24);
-    wordsText.setPosition(500, static_cast<float>(window.getSize().y - wordsText.getCharacterSize() * 1.4));
+    wordsText.setPosition(500, static_cast<float>(windowSize.y - wordsText.getCharacterSize() * 1.4));
 
     sf::Text wordsValueText("", interfaceFont, 24);
     wordsValueText.setPosition(wordsText.getPosition().x + 15, wordsText.getPosition().y);
@@ -257,20 +273,53 @@ int main() {
     sf::Text wpmText("WPM: ", interfaceFont, 24);
     wpmText.setPosition(353, 250);
 
-    // Words for the game
+    // Words for the game, the keys of words from a list are folded once into wordListKeys
     std::vector<Word> words;
-    for (const auto& text : wordsSource) {
-        Word newWord(text, interfaceFont, 24);
-        newWord.text.setPosition(-newWord.text.getGlobalBounds().width, 0);
-        newWord.text.setFillColor(sf::Color(10, 255, 140));
-        words.push_back(newWord);
+    std::vector<std::u32string> wordListKeys;
+    std::vector<std::size_t> builtInPositions;  // Position in words of every built-in word, kept up to date by seedGame
+    if (wordList.empty()) {
+        words.reserve(builtInWords.size());
+        for (auto const& word : builtInWords)
+            words.emplace_back(word, interfaceFont, 24);
+        builtInPositions.resize(builtInWords.size());
+    } else {
+        words.reserve(wordList.size());
+        wordListKeys.reserve(wordList.size());
+        for (auto const& text : wordList) {
+            wordListKeys.push_back(my_library::foldCase(my_library::toUtf32(text)));
+            words.emplace_back(text, wordListKeys.back(), interfaceFont, 24);
+        }
+    }
+    for (auto& word : words) {
+        word.text.setPosition(-word.text.getGlobalBounds().width, 0);
+        word.text.setFillColor(sf::Color(10, 255, 140));
     }
 
     auto wordIter = words.begin();
 
+    // Every game draws from one seed, logged so the game can be replayed with --seed
+    my_library::RngService rng;
+    auto& shuffleRng = rng.stream(my_library::RngStream::Shuffle);
+    auto& spawnRng = rng.stream(my_library::RngStream::SpawnY);
+
+    auto seedGame = [&](std::uint64_t seed) {
+        rng.reseed(seed);
+        fmt::println(std::clog, "Game seed {}", seed);
+        // Words that fold to the same key are ordered by text, so the shuffle never depends on the previous game's order
+        std::ranges::sort(words, [](Word const& a, Word const& b) {
+            return std::tie(a.key, a.text.getString()) < std::tie(b.key, b.text.getString());
+        });
+        shuffleRng.shuffle(words);
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (words[i].builtIn >= 0)
+                builtInPositions[static_cast<std::size_t>(words[i].builtIn)] = i;
+        }
+        wordIter = words.begin();
+    };
+
     // User input decorations and cursor
     sf::Text decor_userInput("[                            ]", interfaceFont, 24);
-    decor_userInput.setPosition(5, static_cast<float>(window.getSize().y - decor_userInput.getCharacterSize() * 1.5));
+    decor_userInput.setPosition(5, static_cast<float>(windowSize.y - decor_userInput.getCharacterSize() * 1.5));
 
     sf::Text userInput("", interfaceFont, 24);
 
@@ -280,11 +329,11 @@ int main() {
     sf::Clock cursorClock;
     bool cursorVisible = true;
 
-    std::string inputStr;
+    std::u32string inputStr;
 
     // Time and missedCount texts
     sf::Text timeText("Time: ", interfaceFont, 24);
-    timeText.setPosition(static_cast<float>(window.getSize().x - timeText.getCharacterSize() * 6 + 5), static_cast<float>(window.getSize().y - timeText.getCharacterSize() * 1.4));
+    timeText.setPosition(static_cast<float>(windowSize.x - timeText.getCharacterSize() * 6 + 5), static_cast<float>(windowSize.y - timeText.getCharacterSize() * 1.4));
 
     sf::Text timeValueText("", interfaceFont, 24);
     timeValueText.setPosition(timeText.getPosition());
@@ -292,7 +341,7 @@ int main() {
 
     int missedCount = 0;
     sf::Text missedText("Missed: ", interfaceFont, 24);
-    missedText.setPosition(decor_userInput.getGlobalBounds().width + 20, static_cast<float>(window.getSize().y - missedText.getCharacterSize() * 1.4));
+    missedText.setPosition(decor_userInput.getGlobalBounds().width + 20, static_cast<float>(windowSize.y - missedText.getCharacterSize() * 1.4));
 
     sf::Text missedValueText("        ", interfaceFont, 24);
     missedValueText.setPosition(missedText.getPosition().x + 5, missedText.getPosition().y);
@@ -309,8 +358,63 @@ int main() {
 
     sf::Clock gameClock;
 
-    sf::Texture screenTexture;
-    sf::Sprite screenSprite;
+    // Per-keystroke telemetry, summarized off the game loop and shown on the Game Over screen
+    my_library::Telemetry telemetry;
+    using TelemetryType = my_library::TelemetryEvent::Type;
+    auto recordTelemetry = [&](TelemetryType type, Word const* word = nullptr) {
+        auto index = word != nullptr ? static_cast<std::uint32_t>(word - words.data()) : 0;
+        telemetry.record(type, gameClock.getElapsedTime().asSeconds(), index);
+    };
+    bool telemetryShown = false;
+    std::ofstream telemetryFile;
+    if (saveTelemetry)
+        telemetryFile.open("../assets/telemetry.txt", std::ios::out | std::ios::app);
+
+    sf::Text telemetryText("", arialFont, 14);
+    telemetryText.setPosition(10, static_cast<float>(windowSize.y - 26));
+    telemetryText.setFillColor(sf::Color(200, 200, 200));
+
+    // Race mode: every participant of a session plays the same word order with the same settings
+    sf::Text raceText("", interfaceFont, 24);
+    raceText.setPosition(static_cast<float>(windowSize.x - 190), 5);
+    raceText.setFillColor(sf::Color(255, 255, 140));
+
+    // Seeds the game with the session's seed, false when not racing
+    auto joinRace = [&]() -> bool {
+        if (!raceClient.isConnected())
+            return false;
+        auto welcome = raceClient.join(raceSession, nickname);
+        if (!welcome)
+            return false;
+
+        racePlayer = welcome->player;
+        racers.clear();
+        wordSpeed = static_cast<float>(welcome->speed) / 100.0f;
+        maxWordFrequency = static_cast<float>(welcome->maxFreq) / 10.0f;
+
+        seedGame(welcome->seed);
+        for (auto& word : words)
+            word.text.setPosition(-word.text.getGlobalBounds().width, 0);
+        return true;
+    };
+
+    auto sendRaceProgress = [&](bool finished) {
+        race::Progress progress;
+        progress.finished = finished;
+        progress.player = racePlayer;
+        progress.elapsedMs = static_cast<std::uint32_t>(gameClock.getElapsedTime().asSeconds() * 1000);
+        progress.score = static_cast<std::uint32_t>(score);
+        progress.wpm = static_cast<std::uint16_t>(wpm);
+        progress.wordsFinished = static_cast<std::uint16_t>(wordsFinished);
+        progress.missed = static_cast<std::uint8_t>(missedCount);
+        raceClient.sendProgress(progress);
+    };
+
+    // The game scene is rendered into this texture and composited to the window,
+    // the Game Over screen reuses the last frame from it as its background
+    sf::RenderTexture sceneTexture;
+    sceneTexture.create(windowSize.x, windowSize.y);
+    sf::Sprite sceneSprite(sceneTexture.getTexture());
 
     // Main title
     sf::Text stanTyperText("StanTyper", interfaceFont, 90);
@@ -375,21 +479,12 @@ int main() {
 
 
     sf::Text versionText("v0.1.0-alpha", arialFont, 12);
-    versionText.setPosition(5, static_cast<float>(window.getSize().y - versionText.getCharacterSize() * 1.5));
+    versionText.setPosition(5, static_cast<float>(windowSize.y - versionText.getCharacterSize() * 1.5));
     versionText.setFillColor(sf::Color(120, 120, 120));
     versionText.setStyle(sf::Text::Italic);
 
     sf::Clock timeBetweenMenus;
 
-    // Filling top scores vector with empty strings for now
-    std::vector<sf::Text> topScoresTexts;
-    std::vector<sf::Text> topScoresHeaderTexts;
-    for (int i = 0; i < 10; ++i) {
-        sf::Text text("", interfaceFont, 24);
-        text.setPosition(10, static_cast<float>(window.getSize().y - (10 - i) * text.getCharacterSize() * 2));
-        topScoresTexts.push_back(text);
-    }
-
     // Predefined positions for topScoresTexts columns
     float nicknameX = 10;
     float scoreX = nicknameX + 150;
@@ -398,11 +493,326 @@ int main() {
     float maxFreqX = speedX + 100;
     float timeX = maxFreqX + 100;
     float dateX = timeX + 100;
+    std::vector<float> columnsX = {nicknameX, scoreX, wpmX, speedX, maxFreqX, timeX, dateX};
+
+    // Scoreboard texts are built once, rows are updated in place when the scores arrive
+    std::vector<sf::Text> topScoresHeaderTexts;
+    std::vector<std::string> headers = {"Nickname:", "Score:", "WPM:", "Speed:", "Freq.:", "Time:", "Date:"};
+    for (std::size_t column = 0; column < headers.size(); ++column) {
+        sf::Text headerText(headers[column], interfaceFont, 30);
+        headerText.setPosition(columnsX[column], 10);
+        headerText.setFillColor(sf::Color(255, 255, 140));
+        topScoresHeaderTexts.push_back(headerText);
+    }
+
+    std::vector<sf::Text> topScoresTexts;
+    for (int i = 1; i <= 10; ++i) {
+        for (float x : columnsX) {
+            sf::Text text("", interfaceFont, 24);
+            text.setPosition(x, static_cast<float>(windowSize.y) - static_cast<float>(i) * 52);
+            topScoresTexts.push_back(text);
+        }
+    }
+    std::size_t topScoresCount = 0;
+
+    sf::Text loadingScoresText("Loading scores...", interfaceFont, 30);
+    loadingScoresText.setPosition(270, 280);
+
+    // Place of the last game among all games ever saved
+    sf::Text placeText("", interfaceFont, 20);
+    placeText.setPosition(120, 285);
+    placeText.setFillColor(sf::Color(255, 255, 140));
+
+    // The scores file is read once on a worker, the screens keep rendering until it is ready.
+    // Games saved afterwards are added to the leaderboard as they are played.
+    // The benchmark never shows the scoreboard and would wait for the load on exit, so it skips it.
+    std::future<my_library::Leaderboard> leaderboardFuture;
+    if (benchFrames == 0) {
+        std::error_code scoresSizeError;
+        auto scoresSize = std::filesystem::file_size("../assets/scores.txt", scoresSizeError);
+        leaderboardFuture = std::async(std::launch::async, my_library::loadLeaderboard, "../assets/scores.txt", scoresSizeError ? 0 : scoresSize);
+    }
+    my_library::Leaderboard leaderboard;
+    std::vector<Game> unrankedGames;    // Saved while the leaderboard was still loading
+    std::optional<int> rankedScore;     // Score of the last saved game
+
+    auto rankGame = [&](Game const& game) {
+        if (leaderboardFuture.valid())
+            unrankedGames.push_back(game);
+        else
+            leaderboard.insert(game);
+        rankedScore = game.score;
+    };
+
+    auto downloadScores = [&]() {
+        placeText.setString("");
+        if (leaderboardFuture.valid()) {
+            if (leaderboardFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return;
+            leaderboard = leaderboardFuture.get();
+            for (auto& game : unrankedGames)
+                leaderboard.insert(std::move(game));
+            unrankedGames.clear();
+        }
+
+        if (rankedScore) {
+            auto place = leaderboard.rank(*rankedScore);
+            auto text = fmt::format("You placed #{} of {} (top {:.1f}%)", place, leaderboard.size(), leaderboard.percentile(place));
+            if (place > 1) {
+                auto const& next = leaderboard.at(place - 1);
+                text += fmt::format(", next: {} +{}", next.nickname, next.score - *rankedScore);
+            }
+            placeText.setString(text);
+        }
+
+        // Rows are laid out from the bottom up, the best score goes into the last filled row
+        auto tempVec = leaderboard.page(1, 10);
+        std::ranges::reverse(tempVec);
+        topScoresCount = tempVec.size();
+        for (std::size_t i = 0; i < topScoresCount; ++i) {
+            auto row = topScoresTexts.begin() + static_cast<std::ptrdiff_t>(i * columnsX.size());
+            row[0].setString(tempVec[i].nickname);
+            row[1].setString(std::to_string(tempVec[i].score));
+            row[2].setString(std::to_string(tempVec[i].wpm));
+            row[3].setString(std::to_string(tempVec[i].speed));
+            row[4].setString(std::to_string(tempVec[i].maxFreq));
+            row[5].setString(fmt::format("{:.2f}s", tempVec[i].time));
+            row[6].setString(tempVec[i].date);
+        }
+        scoreDownloaded = true;
+    };
+
+    // Words turn yellow and then red as they get closer to the right edge
+    auto colorWord = [&](Word& word) {
+        if (word.text.getPosition().x >= windowSize.x / 1.8)
+            word.text.setFillColor(sf::Color(255, 255, 140)); // Yellow
+        if (word.text.getPosition().x >= windowSize.x / 1.2)
+            word.text.setFillColor(sf::Color(255, 110, 110)); // Red
+    };
+
+    // Drawing of the game and Game Over screens, shared by the game loop and the offscreen benchmark
+    auto drawGameScene = [&](my_library::CountingTarget target) {
+        target.draw(animationSprite);
+        for (auto iterator = words.begin(); iterator != wordIter; iterator++) {
+            if (!iterator->isFinished)
+                target.draw(iterator->text);
+        }
+        if (cursorVisible)
+            target.draw(cursor);
+
+        target.draw(scoreText);
+        target.draw(scoreValueText);
+        target.draw(missedText);
+        target.draw(missedValueText);
+        target.draw(wordsText);
+        target.draw(wordsValueText);
+        target.draw(timeText);
+        target.draw(timeValueText);
+        target.draw(decor_userInput);
+        target.draw(userInput);
+        if (raceClient.isConnected())
+            target.draw(raceText);
+    };
+
+    auto drawGameOver = [&](my_library::CountingTarget target) {
+        target.draw(sceneSprite);
+        target.draw(gameOverOverlay);
+        target.draw(gameOverText);
+        target.draw(scoreText);
+        target.draw(scoreValueText);
+        target.draw(wpmText);
+        target.draw(placeText);
+        target.draw(telemetryText);
+        target.draw(pointerText);
+        for (const auto& text : gameOverScreen_Buttons)
+            target.draw(text);
+    };
+
+    // Offscreen benchmark (--bench): renders a fixed synthetic game with benchDensity words and the Game Over overlay
+    // on top of it, without a window, so it also runs on build machines with software OpenGL (xvfb-run and Mesa llvmpipe)
+    if (benchFrames > 0) {
+        sf::RenderTexture frameTexture;
+        if (!frameTexture.create(windowSize.x, windowSize.y)) {
+            fmt::println(std::cerr, "Cannot create a render texture");
+            return 1;
+        }
+
+        // Same words, positions and HUD in every run, so golden frames stay comparable
+        seedGame(1);
+        benchDensity = std::min(benchDensity, words.size());
+        wordIter = words.begin() + static_cast<std::ptrdiff_t>(benchDensity);
+        for (std::size_t i = 0; i < benchDensity; ++i) {
+            auto& word = words[i];
+            word.isFinished = false;
+            word.text.setFillColor(sf::Color(10, 255, 140));
+            word.text.setPosition(static_cast<float>(i * windowSize.x / benchDensity) - word.text.getGlobalBounds().width,
+                                  static_cast<float>(spawnRng.between(20, 530)));
+            colorWord(word);
+        }
+
+        inputStr = words.front().key.substr(0, 3);
+        userInput.setString(my_library::toSfString(inputStr));
+        cursor.setPosition(userInput.getGlobalBounds().width + 16, userInput.getPosition().y + 24);
+        scoreValueText.setString("       12345");
+        missedValueText.setString("         3");
+        wordsValueText.setString("       42/" + std::to_string(words.size()));
+        timeValueText.setString("        42.00");
+        gameOverText.setString("Game Over");
+        gameOverText.setFillColor(sf::Color::Red);
+        wpmText.setString("WPM: 60");
+        placeText.setString("You placed #4312 of 250000 (top 1.7%), next: Guest1234 +5");
+        telemetryText.setString("Last 10s: 66 WPM (peak 72)   Reaction p50/p90/p99: 1.20/2.10/3.40s   Errors: 4.2%   Backspaces: 7");
+        pointerText.setPosition(280, 320);
+
+        my_library::DrawStats stats;
+        std::vector<float> frameTimes;
+        frameTimes.reserve(benchFrames);
+        std::size_t mismatches = 0;
+        sf::Clock frameClock;
+        for (std::size_t frame = 0; frame < benchFrames; ++frame) {
+            animationSprite.setTexture(animationFrames[frame % animationFrames.size()]);
+            for (auto iterator = words.begin(); iterator != wordIter; iterator++) {
+                iterator->text.move(2, 0);
+                if (iterator->text.getPosition().x > static_cast<float>(windowSize.x)) {
+                    iterator->text.setPosition(-iterator->text.getGlobalBounds().width, iterator->text.getPosition().y);
+                    iterator->text.setFillColor(sf::Color(10, 255, 140));
+                }
+                colorWord(*iterator);
+            }
+
+            frameClock.restart();
+            sceneTexture.clear();
+            drawGameScene({sceneTexture, &stats});
+            sceneTexture.display();
+            frameTexture.clear();
+            drawGameOver({frameTexture, &stats});
+            frameTexture.display();
+            glFinish();     // Time the rendering itself, not only submitting it
+            frameTimes.push_back(frameClock.getElapsedTime().asSeconds() * 1000);
+
+            // Golden frames at the start, middle and end, compared when they exist and saved otherwise
+            if (!goldenDir.empty() && (frame == 0 || frame == benchFrames / 2 || frame == benchFrames - 1)) {
+                auto image = frameTexture.getTexture().copyToImage();
+                auto path = fmt::format("{}/bench_{}_{}.png", goldenDir, benchDensity, frame);
+                sf::Image golden;
+                if (std::filesystem::exists(path) && golden.loadFromFile(path)) {
+                    if (auto differing = my_library::countDifferentPixels(image, golden); differing != 0) {
+                        fmt::println(std::cerr, "{}: {} pixels differ", path, differing);
+                        mismatches++;
+                    }
+                } else {
+                    std::filesystem::create_directories(goldenDir);
+                    image.saveToFile(path);
+                    fmt::println("Saved golden frame {}", path);
+                }
+            }
+        }
+
+        fmt::println("words: {}  draw calls/frame: {}  vertices/frame: {}", benchDensity, stats.drawCalls / benchFrames, stats.vertices / benchFrames);
+        my_library::printFrameTimes(frameTimes);
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    // Resets the game state and starts a new game with the words in a new order
+    auto playAgain = [&]() {
+        scoreText.setPosition(370, static_cast<float>(windowSize.y - scoreText.getCharacterSize() * 1.4));
+        scoreValueText.setPosition(scoreText.getPosition().x + 5, scoreText.getPosition().y);
+        scoreValueText.setFillColor(sf::Color(255, 255, 140));
+
+        userInput.setCharacterSize(24);
+        userInput.setString("");
+        userInput.setPosition(13, static_cast<float>(windowSize.y - userInput.getCharacterSize() * 1.5));
+        userInput.setFillColor(sf::Color::White);
+        cursor.setSize(sf::Vector2f(14, 2));
+
+        for (auto& word : words) {
+            word.isFinished = true;
+            word.text.setPosition(-word.text.getGlobalBounds().width, 0);
+            word.text.setFillColor(sf::Color(10, 255, 140));
+            wordIter = words.begin();
+        }
+        score = 0;
+        wpm = 0;
+        missedCount = 0;
+        wordsFinished = 0;
+        scoreSaved = false;
+        scoreDownloaded = false;
+        if (!joinRace())
+            seedGame(fixedSeed.value_or(my_library::RngService::freshSeed()));
+
+        gameClock.restart();
+        telemetry.start();
+        telemetryShown = false;
+        gameState = Screen::Game;
+    };
+
+    // Scripted workload for profiling (--autoplay): a bot types the rightmost word on screen,
+    // one character per frame, and starts a new game whenever one ends
+    std::u32string botWord;
+    std::size_t botTyped = 0;
+    auto autoplay = [&](std::vector<sf::Event>& events) {
+        if (gameState == Screen::GameOver) {
+            playAgain();
+            return;
+        }
+        if (gameState != Screen::Game)
+            return;
+
+        if (botWord.empty()) {
+            auto target = words.end();
+            for (auto iter = words.begin(); iter != wordIter; iter++) {
+                if (!iter->isFinished && (target == words.end() || iter->text.getPosition().x > target->text.getPosition().x))
+                    target = iter;
+            }
+            if (target == words.end())
+                return;
+            botWord = target->key;
+            botTyped = 0;
+        }
+
+        sf::Event event{};
+        event.type = sf::Event::TextEntered;
+        if (botTyped < botWord.size()) {
+            event.text.unicode = botWord[botTyped++];
+        } else {
+            event.text.unicode = '\r';
+            botWord.clear();
+        }
+        events.push_back(event);
+    };
+
+    std::vector<sf::Event> events;
+    std::vector<float> frameTimes;
+    sf::Clock frameClock;
+    if (autoplayFrames > 0) {
+        nickname = "Autoplay";
+        window.setVerticalSyncEnabled(false);
+        frameTimes.reserve(autoplayFrames);
+        playAgain();
+    }
+
+    // Live stats for external dashboards (StatsReader), published once per frame without blocking
+    live_stats::Writer liveStats;
+    sf::Clock inputClock;
+    float inputLatencyMs = 0;
+    std::uint64_t frameNumber = 0;
 
     // Main loop
     while (window.isOpen()) {
-        sf::Event event{};
-        while (window.pollEvent(event)) {
+        events.clear();
+        sf::Event polledEvent{};
+        while (window.pollEvent(polledEvent))
+            events.push_back(polledEvent);
+        if (autoplayFrames > 0)
+            autoplay(events);
+
+        bool keyPolled = std::ranges::any_of(events, [](sf::Event const& event) {
+            return event.type == sf::Event::KeyPressed || event.type == sf::Event::TextEntered;
+        });
+        if (keyPolled)
+            inputClock.restart();
+
+        for (auto const& event : events) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
@@ -414,16 +824,20 @@ int main() {
                         inputStr.clear();
                         userInput.setCharacterSize(24);
                         userInput.setString("");
-                        userInput.setPosition(13, static_cast<float>(window.getSize().y - userInput.getCharacterSize() * 1.5));
+                        userInput.setPosition(13, static_cast<float>(windowSize.y - userInput.getCharacterSize() * 1.5));
                         userInput.setFillColor(sf::Color::White);
                         cursor.setSize(sf::Vector2f(14, 2));
 
                         if (nickname.empty())
-                            nickname = "Guest" + std::to_string(my_library::getRandomInt(1000, 9999));
+                            nickname = "Guest" + std::to_string(rng.stream(my_library::RngStream::Names).between(1000, 9999));
 
                         scoreSaved = false;
                         scoreDownloaded = false;
+                        if (!joinRace())
+                            seedGame(fixedSeed.value_or(my_library::RngService::freshSeed()));
                         gameClock.restart();
+                        telemetry.start();
+                        telemetryShown = false;
                         gameState = Screen::Game;
                         timeBetweenMenus.restart();
                     } else if (startingScreen_CurrentIndex == 1) {
@@ -433,7 +847,7 @@ int main() {
                     else if (startingScreen_CurrentIndex == 2) {
                         userInput.setCharacterSize(36);
                         userInput.setPosition(455, 123);
-                        inputStr = nickname;
+                        inputStr = std::u32string(nickname.begin(), nickname.end());
                         userInput.setFillColor(sf::Color(255, 255, 140));
                         cursor.setSize(sf::Vector2f(21, 3));
                         gameState = Screen::Options;
@@ -513,70 +927,62 @@ int main() {
                         if (!inputStr.empty())
                             inputStr.pop_back();
                     } else if (inputStr.size() <= 20 && event.text.unicode != '\r') {
-                        inputStr += static_cast<char>(event.text.unicode);
+                        inputStr += static_cast<char32_t>(event.text.unicode);
                     }
                 }
             } else if (gameState == Screen::Game && event.type == sf::Event::TextEntered) {
-                if (event.text.unicode < 128 && event.text.unicode != ' ') {
+                if (event.text.unicode != ' ') {
 
                     //Handling: Backspace
                     if (event.text.unicode == '\b') {
+                        recordTelemetry(TelemetryType::Backspace);
                         if (!inputStr.empty())
                             inputStr.pop_back();
 
                         // Handling: Enter
                     } else if (event.text.unicode == '\r') {
-                        for (auto& word : words) {
-                            if (my_library::equalsIgnoreCase(word.text.getString(), inputStr) and !word.isFinished) {
-                                score = wordsFinished * static_cast<int>(static_cast<float>(wpm) * wordSpeed * maxWordFrequency * 20); // score aktualizowany po trafieniu slowa
-                                word.isFinished = true;
-                                wordsFinished++;
-                                break;
+                        // Built-in words go straight from their perfect hash slot to their Word, words from a list are found by hash and key
+                        auto inputKey = my_library::foldCase(inputStr);
+                        Word* found = nullptr;
+                        if (!builtInPositions.empty()) {
+                            if (auto builtIn = findBuiltInWord(inputKey); builtIn >= 0)
+                                found = &words[builtInPositions[static_cast<std::size_t>(builtIn)]];
+                        } else {
+                            auto inputHash = wordHash(inputKey);
+                            for (auto& word : words) {
+                                if (!word.isFinished && word.hash == inputHash && word.key == inputKey) {
+                                    found = &word;
+                                    break;
+                                }
                             }
                         }
+                        if (found != nullptr && !found->isFinished) {
+                            score = wordsFinished * static_cast<int>(static_cast<float>(wpm) * wordSpeed * maxWordFrequency * 20); // score aktualizowany po trafieniu slowa
+                            found->isFinished = true;
+                            wordsFinished++;
+                            recordTelemetry(TelemetryType::WordFinished, found);
+                            sendRaceProgress(false);
+                        } else if (!inputStr.empty()) {
+                            recordTelemetry(TelemetryType::WrongSubmit);
+                        }
                         inputStr.clear();
                     } else {
+                        recordTelemetry(TelemetryType::Key);
                         if (userInput.getGlobalBounds().width < decor_userInput.getGlobalBounds().width - 36)
-                            inputStr += static_cast<char>(event.text.unicode);
+                            inputStr += static_cast<char32_t>(event.text.unicode);
                     }
                 }
             } else if (gameState == Screen::GameOver && event.type == sf::Event::KeyPressed) {
                 if (event.key.code == sf::Keyboard::Enter && timeBetweenMenus.getElapsedTime().asSeconds() > 1) {
                     if (gameOverScreen_CurrentIndex == 0) {
-                        scoreText.setPosition(370, static_cast<float>(window.getSize().y - scoreText.getCharacterSize() * 1.4));
-                        scoreValueText.setPosition(scoreText.getPosition().x + 5, scoreText.getPosition().y);
-                        scoreValueText.setFillColor(sf::Color(255, 255, 140));
-
-                        userInput.setCharacterSize(24);
-                        userInput.setString("");
-                        userInput.setPosition(13, static_cast<float>(window.getSize().y - userInput.getCharacterSize() * 1.5));
-                        userInput.setFillColor(sf::Color::White);
-                        cursor.setSize(sf::Vector2f(14, 2));
-
-                        std::ranges::shuffle(words, std::random_device());
-
-                        for (auto& word : words) {
-                            word.isFinished = true;
-                            word.text.setPosition(-word.text.getGlobalBounds().width, 0);
-                            word.text.setFillColor(sf::Color(10, 255, 140));
-                            wordIter = words.begin();
-                        }
-                        score = 0;
-                        wpm = 0;
-                        missedCount = 0;
-                        wordsFinished = 0;
-                        scoreSaved = false;
-                        scoreDownloaded = false;
-
-                        gameClock.restart();
-                        gameState = Screen::Game;
+                        playAgain();
                     } else if (gameOverScreen_CurrentIndex == 1) {
                         scoreDownloaded = false;
                         gameState = Screen::Score;
                     } else if (gameOverScreen_CurrentIndex == 2) {
                         userInput.setCharacterSize(36);
                         userInput.setPosition(455, 123);
-                        inputStr = nickname;
+                        inputStr = std::u32string(nickname.begin(), nickname.end());
 
                         userInput.setFillColor(sf::Color(255, 255, 140));
                         cursor.setSize(sf::Vector2f(21, 3));
@@ -632,7 +1038,7 @@ int main() {
 
             window.draw(menuSprite);
 
-            userInput.setString(inputStr);
+            userInput.setString(my_library::toSfString(inputStr));
             cursor.setPosition(userInput.getGlobalBounds().width + 458, userInput.getPosition().y + 36);
 
             pointerText.setPosition(optionsScreen_CurrentIndex == 0 ? 425 : 490, static_cast<float>(
@@ -662,17 +1068,14 @@ int main() {
             window.draw(pointerText);
             window.display();
         } else if (gameState == Screen::Game) {
-            window.clear();
-
-            // Drawing animation
+            // Animation
             if (animationClock.getElapsedTime().asSeconds() >= frameDuration) {
                 currentFrame = (currentFrame + 1) % static_cast<int>(animationFrames.size());
                 animationSprite.setTexture(animationFrames[currentFrame]);
                 animationClock.restart();
             }
-            window.draw(animationSprite);
 
-            userInput.setString(inputStr);
+            userInput.setString(my_library::toSfString(inputStr));
             cursor.setPosition(userInput.getGlobalBounds().width + 16, userInput.getPosition().y + 24);
             wordTime += wordClock.restart();
 
@@ -680,7 +1083,7 @@ int main() {
             if (wordTime.asSeconds() >= wordFrequency && wordIter != words.end()) {
                 bool positionFound = false;
                 while (!positionFound) {
-                    wordIter->text.setPosition(-wordIter->text.getGlobalBounds().width, static_cast<float>(my_library::getRandomInt(20, 530)));
+                    wordIter->text.setPosition(-wordIter->text.getGlobalBounds().width, static_cast<float>(spawnRng.between(20, 530)));
                     positionFound = true;
 
                     // Checking for intersections
@@ -692,29 +1095,24 @@ int main() {
                     }
                 }
                 wordIter->isFinished = false;
+                recordTelemetry(TelemetryType::WordSpawned, &*wordIter);
                 wordIter++;
                 wordFrequency = std::max(wordFrequency - 0.05f, maxWordFrequency);
                 wordTime = sf::Time::Zero;
             }
 
 
-            // Displaying words
+            // Moving words
             for (auto iterator = words.begin(); iterator != wordIter; iterator++) {
                 if (!iterator->isFinished) {
-                    window.draw(iterator->text);
                     iterator->text.move(wordSpeed, 0);
-
-                    // Coloring words
-                    if (iterator->text.getPosition().x >= window.getSize().x / 1.8)
-                        iterator->text.setFillColor(sf::Color(255, 255, 140)); // Yellow
-                    if (iterator->text.getPosition().x >= window.getSize().x / 1.2)
-                        iterator->text.setFillColor(sf::Color(255, 110, 110)); // Red
+                    colorWord(*iterator);
 
                         // When word leaves the screen
-                    if (iterator->text.getPosition().x > static_cast<float>(window.getSize().x)) {
+                    if (iterator->text.getPosition().x > static_cast<float>(windowSize.x)) {
                         bool positionFound = false;
                         while (!positionFound) {
-                            iterator->text.setPosition(-iterator->text.getGlobalBounds().width, static_cast<float>(my_library::getRandomInt(20, 530)));
+                            iterator->text.setPosition(-iterator->text.getGlobalBounds().width, static_cast<float>(spawnRng.between(20, 530)));
                             positionFound = true;
 
                             // Checking for intersections
@@ -729,6 +1127,9 @@ int main() {
                         // Color reset
                         iterator->text.setFillColor(sf::Color(10, 255, 140));
                         missedCount++;
+                        recordTelemetry(TelemetryType::WordMissed, &*iterator);
+                        recordTelemetry(TelemetryType::WordSpawned, &*iterator);
+                        sendRaceProgress(false);
                     }
                 }
             }
@@ -751,23 +1152,23 @@ int main() {
                 cursorVisible = !cursorVisible;
                 cursorClock.restart();
             }
-            if (cursorVisible)
-                window.draw(cursor);
 
             scoreValueText.setString("       " + std::to_string(score));
             wordsValueText.setString("       " + std::to_string(wordsFinished) + "/" + std::to_string(words.size()));
 
-            window.draw(scoreText);
-            window.draw(scoreValueText);
-            window.draw(missedText);
-            window.draw(missedValueText);
-            window.draw(wordsText);
-            window.draw(wordsValueText);
-            window.draw(timeText);
-            window.draw(timeValueText);
-            window.draw(decor_userInput);
-            window.draw(userInput);
+            // Race position among the participants of the session
+            if (raceClient.isConnected()) {
+                for (auto const& progress : raceClient.poll())
+                    racers[progress.player] = progress;
+                auto place = 1 + std::ranges::count_if(racers, [&](auto const& racer) { return static_cast<int>(racer.second.score) > score; });
+                raceText.setString("Race: " + std::to_string(place) + "/" + std::to_string(racers.size() + 1));
+            }
 
+            sceneTexture.clear();
+            drawGameScene(sceneTexture);
+            sceneTexture.display();
+            window.clear();
+            window.draw(sceneSprite);
             window.display();
 
             if (missedCount == 10) {
@@ -776,16 +1177,17 @@ int main() {
                 gameOverText.setString("Game Over");
                 gameOverText.setFillColor(sf::Color::Red);
 
-                screenTexture.create(window.getSize().x, window.getSize().y);
-                screenTexture.update(window);
-                screenSprite.setTexture(screenTexture);
-
                 if (!scoreSaved) {
                     std::time_t t = std::time(nullptr);
                     std::tm* date = std::localtime(&t);
 
                     auto game = Game(nickname, score, wpm, static_cast<int>(wordSpeed * 100), static_cast<int>(maxWordFrequency * 10), gameClock.getElapsedTime().asSeconds(), my_library::timeToStr(*date));
-                    game.saveScoreToFile();
+                    if (autoplayFrames == 0) {
+                        game.saveScoreToFile();
+                        rankGame(game);
+                    }
+                    sendRaceProgress(true);
+                    recordTelemetry(TelemetryType::GameEnd);
                     scoreSaved = true;
                 }
             } else if (wordsFinished == words.size()) {
@@ -794,96 +1196,25 @@ int main() {
                 gameOverText.setString("You win!");
                 gameOverText.setFillColor(sf::Color(10, 255, 140));
 
-                screenTexture.create(window.getSize().x, window.getSize().y);
-                screenTexture.update(window);
-                screenSprite.setTexture(screenTexture);
-
                 if (!scoreSaved) {
                     std::time_t t = std::time(nullptr);
                     std::tm* date = std::localtime(&t);
 
                     auto game = Game(nickname, score, wpm, static_cast<int>(wordSpeed * 100), static_cast<int>(maxWordFrequency * 10), gameClock.getElapsedTime().asSeconds(), my_library::timeToStr(*date));
-                    game.saveScoreToFile();
+                    if (autoplayFrames == 0) {
+                        game.saveScoreToFile();
+                        rankGame(game);
+                    }
+                    sendRaceProgress(true);
+                    recordTelemetry(TelemetryType::GameEnd);
                     scoreSaved = true;
                 }
             }
         } else if (gameState == Screen::GameOver) {
             window.clear();
 
-            if (!scoreDownloaded) {
-                auto tempVec = my_library::getTopScorers();
-
-                for (int i = 0; i < tempVec.size() && i < 11; ++i) {
-                    float currentY = static_cast<float>(window.getSize().y) - static_cast<float>(i) * 52;
-                    if (i == 0) {
-                        sf::Text nicknameHeaderText("Nickname:", interfaceFont, 30);
-                        nicknameHeaderText.setPosition(nicknameX, 10);
-                        nicknameHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(nicknameHeaderText);
-
-                        sf::Text scoreHeaderText("Score:", interfaceFont, 30);
-                        scoreHeaderText.setPosition(scoreX, 10);
-                        scoreHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(scoreHeaderText);
-
-                        sf::Text wpmHeaderText("WPM:", interfaceFont, 30);
-                        wpmHeaderText.setPosition(wpmX, 10);
-                        wpmHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(wpmHeaderText);
-
-                        sf::Text speedHeaderText("Speed:", interfaceFont, 30);
-                        speedHeaderText.setPosition(speedX, 10);
-                        speedHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(speedHeaderText);
-
-                        sf::Text maxFreqHeaderText("Freq.:", interfaceFont, 30);
-                        maxFreqHeaderText.setPosition(maxFreqX, 10);
-                        maxFreqHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(maxFreqHeaderText);
-
-                        sf::Text timeHeaderText("Time:", interfaceFont, 30);
-                        timeHeaderText.setPosition(timeX, 10);
-                        timeHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(timeHeaderText);
-
-                        sf::Text dateHeaderText("Date:", interfaceFont, 30);
-                        dateHeaderText.setPosition(dateX, 10);
-                        dateHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(dateHeaderText);
-                    } else {
-                        if (!tempVec.empty()) {
-                            sf::Text nicknameValText(tempVec[i - 1].nickname, interfaceFont, 24);
-                            nicknameValText.setPosition(nicknameX, currentY);
-                            topScoresTexts.push_back(nicknameValText);
-
-                            sf::Text scoreValText(std::to_string(tempVec[i - 1].score), interfaceFont, 24);
-                            scoreValText.setPosition(scoreX, currentY);
-                            topScoresTexts.push_back(scoreValText);
-
-                            sf::Text wpmValText(std::to_string(tempVec[i - 1].wpm), interfaceFont, 24);
-                            wpmValText.setPosition(wpmX, currentY);
-                            topScoresTexts.push_back(wpmValText);
-
-                            sf::Text speedValText(std::to_string(tempVec[i - 1].speed), interfaceFont, 24);
-                            speedValText.setPosition(speedX, currentY);
-                            topScoresTexts.push_back(speedValText);
-
-                            sf::Text maxFreqValText(std::to_string(tempVec[i - 1].maxFreq), interfaceFont, 24);
-                            maxFreqValText.setPosition(maxFreqX, currentY);
-                            topScoresTexts.push_back(maxFreqValText);
-
-                            sf::Text timeValText(fmt::format("{:.2f}s", tempVec[i - 1].time), interfaceFont, 24);
-                            timeValText.setPosition(timeX, currentY);
-                            topScoresTexts.push_back(timeValText);
-
-                            sf::Text dateValText(tempVec[i - 1].date, interfaceFont, 24);
-                            dateValText.setPosition(dateX, currentY);
-                            topScoresTexts.push_back(dateValText);
-                        }
-                    }
-                }
-                scoreDownloaded = true;
-            }
+            if (!scoreDownloaded)
+                downloadScores();
 
             pointerText.setPosition(280, static_cast<float>(
                     gameOverScreen_CurrentIndex == 0 ? 320 :
@@ -896,105 +1227,58 @@ int main() {
             scoreValueText.setPosition(scoreText.getPosition().x + 5, scoreText.getPosition().y);
             wpmText.setString("WPM: " + std::to_string(wpm));
 
-            window.draw(screenSprite);
-            window.draw(gameOverOverlay);
-            window.draw(gameOverText);
-            window.draw(scoreText);
-            window.draw(scoreValueText);
-            window.draw(wpmText);
-            window.draw(pointerText);
-
-            for (const auto& text : gameOverScreen_Buttons) {
-                window.draw(text);
+            // Telemetry summary arrives from the worker a few frames after the game ended
+            if (!telemetryShown) {
+                if (auto summary = telemetry.result()) {
+                    telemetryText.setString(fmt::format("Last 10s: {} WPM (peak {})   Reaction p50/p90/p99: {:.2f}/{:.2f}/{:.2f}s   Errors: {:.1f}%   Backspaces: {}   Dropped events: {}",
+                                                        summary->rollingWpm, summary->peakRollingWpm, summary->reactionP50, summary->reactionP90,
+                                                        summary->reactionP99, summary->errorRate * 100, summary->backspaces, summary->droppedEvents));
+                    if (saveTelemetry) {
+                        std::time_t t = std::time(nullptr);
+                        summary->saveToFile(telemetryFile, nickname, my_library::timeToStr(*std::localtime(&t)));
+                    }
+                    telemetryShown = true;
+                } else if (telemetry.lost()) {
+                    telemetryText.setString("No analytics for this game, its events did not fit into the telemetry ring");
+                    telemetryShown = true;
+                } else {
+                    telemetryText.setString("");
+                }
             }
+
+            drawGameOver(window);
             window.display();
         } else if (gameState == Screen::Score) {
             window.clear();
             window.draw(menuSprite);
 
-            if (!scoreDownloaded) {
-                topScoresTexts.clear();
-                topScoresHeaderTexts.clear();
-                auto tempVec = my_library::getTopScorers();
-
-                for (int i = 0; i <= tempVec.size() && i <= 11; ++i) {
-                    float currentY = static_cast<float>(window.getSize().y) - static_cast<float>(i) * 52;
-                    if (i == 0) {
-                        sf::Text nicknameHeaderText("Nickname:", interfaceFont, 30);
-                        nicknameHeaderText.setPosition(nicknameX, 10);
-                        nicknameHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(nicknameHeaderText);
-
-                        sf::Text scoreHeaderText("Score:", interfaceFont, 30);
-                        scoreHeaderText.setPosition(scoreX, 10);
-                        scoreHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(scoreHeaderText);
-
-                        sf::Text wpmHeaderText("WPM:", interfaceFont, 30);
-                        wpmHeaderText.setPosition(wpmX, 10);
-                        wpmHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(wpmHeaderText);
-
-                        sf::Text speedHeaderText("Speed:", interfaceFont, 30);
-                        speedHeaderText.setPosition(speedX, 10);
-                        speedHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(speedHeaderText);
-
-                        sf::Text maxFreqHeaderText("Freq.:", interfaceFont, 30);
-                        maxFreqHeaderText.setPosition(maxFreqX, 10);
-                        maxFreqHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(maxFreqHeaderText);
-
-                        sf::Text timeHeaderText("Time:", interfaceFont, 30);
-                        timeHeaderText.setPosition(timeX, 10);
-                        timeHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(timeHeaderText);
-
-                        sf::Text dateHeaderText("Date:", interfaceFont, 30);
-                        dateHeaderText.setPosition(dateX, 10);
-                        dateHeaderText.setFillColor(sf::Color(255, 255, 140));
-                        topScoresHeaderTexts.push_back(dateHeaderText);
-                    } else {
-                        if (!tempVec.empty()) {
-                            sf::Text nicknameValText(tempVec[i - 1].nickname, interfaceFont, 24);
-                            nicknameValText.setPosition(nicknameX, currentY);
-                            topScoresTexts.push_back(nicknameValText);
-
-                            sf::Text scoreValText(std::to_string(tempVec[i - 1].score), interfaceFont, 24);
-                            scoreValText.setPosition(scoreX, currentY);
-                            topScoresTexts.push_back(scoreValText);
-
-                            sf::Text wpmValText(std::to_string(tempVec[i - 1].wpm), interfaceFont, 24);
-                            wpmValText.setPosition(wpmX, currentY);
-                            topScoresTexts.push_back(wpmValText);
-
-                            sf::Text speedValText(std::to_string(tempVec[i - 1].speed), interfaceFont, 24);
-                            speedValText.setPosition(speedX, currentY);
-                            topScoresTexts.push_back(speedValText);
-
-                            sf::Text maxFreqValText(std::to_string(tempVec[i - 1].maxFreq), interfaceFont, 24);
-                            maxFreqValText.setPosition(maxFreqX, currentY);
-                            topScoresTexts.push_back(maxFreqValText);
-
-                            sf::Text timeValText(fmt::format("{:.2f}s", tempVec[i - 1].time), interfaceFont, 24);
-                            timeValText.setPosition(timeX, currentY);
-                            topScoresTexts.push_back(timeValText);
-
-                            sf::Text dateValText(tempVec[i - 1].date, interfaceFont, 24);
-                            dateValText.setPosition(dateX, currentY);
-                            topScoresTexts.push_back(dateValText);
-                        }
-                    }
-                }
-                scoreDownloaded = true;
-            }
-            for (auto const& element : topScoresTexts) {
-                window.draw(element);
+            if (!scoreDownloaded)
+                downloadScores();
+
+            if (scoreDownloaded) {
+                for (std::size_t i = 0; i < topScoresCount * columnsX.size(); ++i)
+                    window.draw(topScoresTexts[i]);
+            } else {
+                window.draw(loadingScoresText);
             }
             for (auto const& element : topScoresHeaderTexts) {
                 window.draw(element);
             }
             window.display();
         }
+
+        float frameMs = frameClock.restart().asSeconds() * 1000;
+        if (keyPolled)
+            inputLatencyMs = inputClock.getElapsedTime().asSeconds() * 1000;
+        liveStats.publish({static_cast<std::uint32_t>(gameState), score, wpm, missedCount, wordsFinished,
+                           frameMs, inputLatencyMs, frameNumber++});
+
+        if (autoplayFrames > 0) {
+            frameTimes.push_back(frameMs);
+            if (frameTimes.size() == autoplayFrames) {
+                my_library::printFrameTimes(frameTimes);
+                window.close();
+            }
+        }
     }
 }
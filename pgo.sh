@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Profile-guided release build of Home.
+# Builds the game plain (Release, no LTO), instrumented, and optimized with the recorded profile plus LTO,
+# runs the scripted --autoplay workload headlessly and compares the mean frame time of both release builds.
+#
+# usage: ./pgo.sh [frames] [cmake options...]
+set -euo pipefail
+
+FRAMES=${1:-5000}
+shift || true
+ROOT=$(cd "$(dirname "$0")" && pwd)
+PLAIN=$ROOT/build-plain
+PGO=$ROOT/build-pgo
+PROFILE=$PGO/pgo-profile
+JOBS=$(nproc 2>/dev/null || echo 4)
+
+# The game loads ../assets, so it runs from inside its build directory
+workload() {
+    (cd "$1" && xvfb-run -a -s "-screen 0 1024x768x24" ./Home --autoplay "$FRAMES") | tee /dev/stderr | sed -n 's/.*mean: \([0-9.]*\) ms.*/\1/p'
+}
+
+configure() {
+    cmake -S "$ROOT" -B "$1" -DCMAKE_BUILD_TYPE=Release "${@:2}"
+    cmake --build "$1" --target Home -j"$JOBS"
+}
+
+echo "== plain release build"
+configure "$PLAIN" -DHOME_LTO=OFF -DHOME_PGO=OFF "$@"
+PLAIN_MS=$(workload "$PLAIN")
+
+echo "== instrumented build"
+rm -rf "$PROFILE"
+configure "$PGO" -DHOME_LTO=OFF -DHOME_PGO=GENERATE -DHOME_PGO_DIR="$PROFILE" "$@"
+workload "$PGO" > /dev/null
+if compgen -G "$PROFILE/*.profraw" > /dev/null; then
+    llvm-profdata merge -o "$PROFILE/default.profdata" "$PROFILE"/*.profraw
+fi
+
+echo "== profile-guided LTO build"
+configure "$PGO" -DHOME_LTO=ON -DHOME_PGO=USE -DHOME_PGO_DIR="$PROFILE" "$@"
+PGO_MS=$(workload "$PGO")
+
+echo "== mean frame time over $FRAMES frames"
+awk -v plain="$PLAIN_MS" -v pgo="$PGO_MS" 'BEGIN {
+    printf "plain:   %.3f ms\n", plain
+    printf "pgo+lto: %.3f ms\n", pgo
+    printf "improvement: %.1f%%\n", (plain - pgo) / plain * 100
+}'
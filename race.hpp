@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define RACE_HAS_SOCKETS 1
+#endif
+
+// Binary race protocol, shared by the game client and race_server.cpp.
+// Every message is fixed-size, little-endian and starts with its type byte.
+namespace race {
+    enum class MessageType : std::uint8_t {
+        Join = 1,       // client -> server: enter a session
+        Welcome = 2,    // server -> client: seed and settings of the session
+        Progress = 3,   // both ways: state delta of one participant
+        Finish = 4,     // both ways: final state of one participant
+    };
+
+    constexpr std::size_t nicknameSize = 16;
+
+    struct Join {
+        std::uint32_t session = 0;
+        std::string nickname;
+    };
+
+    struct Welcome {
+        std::uint16_t player = 0;
+        std::uint64_t seed = 0;
+        std::uint8_t speed = 3;     // wordSpeed * 100
+        std::uint8_t maxFreq = 7;   // maxWordFrequency * 10
+    };
+
+    struct Progress {
+        bool finished = false;
+        std::uint16_t player = 0;
+        std::uint32_t elapsedMs = 0;
+        std::uint32_t score = 0;
+        std::uint16_t wpm = 0;
+        std::uint16_t wordsFinished = 0;
+        std::uint8_t missed = 0;
+    };
+
+    constexpr std::size_t joinSize = 1 + 4 + nicknameSize;
+    constexpr std::size_t welcomeSize = 1 + 2 + 8 + 1 + 1;
+    constexpr std::size_t progressSize = 1 + 2 + 4 + 4 + 2 + 2 + 1;
+    constexpr std::size_t maxMessageSize = joinSize;
+
+    // Size of the message starting with the given type byte, 0 for unknown types
+    constexpr auto messageSize(std::uint8_t type) -> std::size_t {
+        switch (static_cast<MessageType>(type)) {
+            case MessageType::Join: return joinSize;
+            case MessageType::Welcome: return welcomeSize;
+            case MessageType::Progress:
+            case MessageType::Finish: return progressSize;
+        }
+        return 0;
+    }
+
+    namespace detail {
+        template<typename T>
+        auto put(std::uint8_t*& out, T value) {
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                *out++ = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * i));
+        }
+
+        template<typename T>
+        auto get(std::uint8_t const*& in) {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                value |= static_cast<std::uint64_t>(*in++) << (8 * i);
+            return static_cast<T>(value);
+        }
+    }
+
+    inline auto encode(Join const& message, std::uint8_t* out) {
+        detail::put(out, MessageType::Join);
+        detail::put(out, message.session);
+        std::array<char, nicknameSize> name{};
+        std::memcpy(name.data(), message.nickname.data(), std::min(message.nickname.size(), nicknameSize - 1));
+        std::memcpy(out, name.data(), name.size());
+    }
+
+    inline auto encode(Welcome const& message, std::uint8_t* out) {
+        detail::put(out, MessageType::Welcome);
+        detail::put(out, message.player);
+        detail::put(out, message.seed);
+        detail::put(out, message.speed);
+        detail::put(out, message.maxFreq);
+    }
+
+    inline auto encode(Progress const& message, std::uint8_t* out) {
+        detail::put(out, message.finished ? MessageType::Finish : MessageType::Progress);
+        detail::put(out, message.player);
+        detail::put(out, message.elapsedMs);
+        detail::put(out, message.score);
+        detail::put(out, message.wpm);
+        detail::put(out, message.wordsFinished);
+        detail::put(out, message.missed);
+    }
+
+    inline auto decodeJoin(std::uint8_t const* in) {
+        Join message;
+        in++;
+        message.session = detail::get<std::uint32_t>(in);
+        // Results are saved as space separated records, so only printable non-space ASCII is kept, as the game's nickname input allows
+        auto name = reinterpret_cast<char const*>(in);
+        for (char c : std::string_view(name, strnlen(name, nicknameSize))) {
+            if (c > ' ' && c < 0x7F)
+                message.nickname += c;
+        }
+        return message;
+    }
+
+    inline auto decodeWelcome(std::uint8_t const* in) {
+        Welcome message;
+        in++;
+        message.player = detail::get<std::uint16_t>(in);
+        message.seed = detail::get<std::uint64_t>(in);
+        message.speed = detail::get<std::uint8_t>(in);
+        message.maxFreq = detail::get<std::uint8_t>(in);
+        return message;
+    }
+
+    inline auto decodeProgress(std::uint8_t const* in) {
+        Progress message;
+        message.finished = static_cast<MessageType>(*in++) == MessageType::Finish;
+        message.player = detail::get<std::uint16_t>(in);
+        message.elapsedMs = detail::get<std::uint32_t>(in);
+        message.score = detail::get<std::uint32_t>(in);
+        message.wpm = detail::get<std::uint16_t>(in);
+        message.wordsFinished = detail::get<std::uint16_t>(in);
+        message.missed = detail::get<std::uint8_t>(in);
+        return message;
+    }
+
+    // Port of a "host:port" address, empty unless it is a whole number from 1 to 65535
+    inline auto parsePort(std::string_view text) -> std::optional<std::uint16_t> {
+        unsigned port = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), port);
+        if (error != std::errc() || end != text.data() + text.size() || port == 0 || port > 65535)
+            return std::nullopt;
+        return static_cast<std::uint16_t>(port);
+    }
+
+    // Address is either "host:port" (local TCP) or a Unix socket path
+    inline auto connectTo(std::string const& address) -> int {
+#ifdef RACE_HAS_SOCKETS
+        auto colon = address.rfind(':');
+        if (colon != std::string::npos && address.find('/') == std::string::npos) {
+            auto port = parsePort(std::string_view(address).substr(colon + 1));
+            if (!port) return -1;
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(*port);
+            if (inet_pton(AF_INET, address.substr(0, colon).c_str(), &addr.sin_addr) != 1)
+                return -1;
+
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0) return -1;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(addr.sun_path)) return -1;
+        std::memcpy(addr.sun_path, address.c_str(), address.size() + 1);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+#else
+        return -1;
+#endif
+    }
+
+    // Game side of a race: one participant of one session
+    class Client {
+        int fd = -1;
+        std::vector<std::uint8_t> buffer;
+
+        auto sendAll(std::uint8_t const* data, std::size_t size) -> bool {
+#ifdef RACE_HAS_SOCKETS
+            while (size > 0) {
+                auto sent = send(fd, data, size, MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    disconnect();
+                    return false;
+                }
+                data += sent;
+                size -= static_cast<std::size_t>(sent);
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        auto receive(int flags) -> bool {
+#ifdef RACE_HAS_SOCKETS
+            std::array<std::uint8_t, 512> chunk{};
+            auto received = recv(fd, chunk.data(), chunk.size(), flags);
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                disconnect();
+                return false;
+            }
+            if (received > 0)
+                buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + received);
+            return received > 0;
+#else
+            return false;
+#endif
+        }
+
+    public:
+        Client() = default;
+        Client(Client const&) = delete;
+        auto operator=(Client const&) -> Client& = delete;
+        ~Client() { disconnect(); }
+
+        auto connect(std::string const& address) -> bool {
+            disconnect();
+            fd = connectTo(address);
+            return fd >= 0;
+        }
+
+        auto disconnect() -> void {
+#ifdef RACE_HAS_SOCKETS
+            if (fd >= 0) close(fd);
+#endif
+            fd = -1;
+            buffer.clear();
+        }
+
+        auto isConnected() const { return fd >= 0; }
+
+        // Blocks until the server answers, the server is on the same machine
+        auto join(std::uint32_t session, std::string const& nickname) -> std::optional<Welcome> {
+            std::array<std::uint8_t, joinSize> message{};
+            encode(Join{session, nickname}, message.data());
+            if (!sendAll(message.data(), message.size()))
+                return std::nullopt;
+
+            while (isConnected()) {
+                while (!buffer.empty() && buffer.size() >= messageSize(buffer[0]) && messageSize(buffer[0]) != 0) {
+                    auto size = messageSize(buffer[0]);
+                    auto type = static_cast<MessageType>(buffer[0]);
+                    std::optional<Welcome> welcome;
+                    if (type == MessageType::Welcome)
+                        welcome = decodeWelcome(buffer.data());
+                    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size));
+                    if (welcome) return welcome;
+                }
+                if (!buffer.empty() && messageSize(buffer[0]) == 0) {
+                    disconnect();
+                    break;
+                }
+                receive(0);
+            }
+            return std::nullopt;
+        }
+
+        auto sendProgress(Progress const& progress) -> void {
+            if (!isConnected()) return;
+            std::array<std::uint8_t, progressSize> message{};
+            encode(progress, message.data());
+            sendAll(message.data(), message.size());
+        }
+
+        // Never blocks, returns the deltas of the other participants received since the last call
+        auto poll() -> std::vector<Progress> {
+            std::vector<Progress> updates;
+            if (!isConnected()) return updates;
+#ifdef RACE_HAS_SOCKETS
+            while (receive(MSG_DONTWAIT)) {}
+#endif
+            std::size_t offset = 0;
+            while (offset < buffer.size()) {
+                auto size = messageSize(buffer[offset]);
+                if (size == 0) {
+                    disconnect();
+                    return updates;
+                }
+                if (buffer.size() - offset < size) break;
+                auto type = static_cast<MessageType>(buffer[offset]);
+                if (type == MessageType::Progress || type == MessageType::Finish)
+                    updates.push_back(decodeProgress(buffer.data() + offset));
+                offset += size;
+            }
+            buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+            return updates;
+        }
+    };
+}
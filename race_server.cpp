@@ -0,0 +1,409 @@
+// Headless race server: hosts many concurrent sessions of the same game on one machine.
+// Every participant of a session gets the same seed, wordSpeed and maxWordFrequency,
+// progress of each participant is relayed to the others, final results are written as Game records.
+#include "game.hpp"
+#include "race.hpp"
+#include "rng.hpp"
+
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <fmt/format.h>
+
+namespace {
+    struct Connection {
+        int fd;
+        std::vector<std::uint8_t> in;
+        std::vector<std::uint8_t> out;
+        std::uint32_t session = 0;
+        std::uint16_t player = 0;
+        std::string nickname;
+        bool joined = false;
+        bool writable = true;
+    };
+
+    struct Session {
+        std::uint64_t seed;
+        std::uint16_t nextPlayer = 0;
+        std::vector<int> members;
+    };
+
+    struct Settings {
+        std::string address = "/tmp/stantyper-race.sock";
+        std::string results = "../assets/race_results.txt";
+        std::uint64_t seed = my_library::RngService::freshSeed();
+        std::uint8_t speed = 3;
+        std::uint8_t maxFreq = 7;
+        int simulatedClients = 0;
+        int playersPerSession = 4;
+    };
+
+    volatile std::sig_atomic_t running = 1;
+
+    auto today() {
+        std::time_t t = std::time(nullptr);
+        std::ostringstream oss;
+        oss << std::put_time(std::localtime(&t), "%d.%m.%Y");
+        return oss.str();
+    }
+
+    auto listenOn(std::string const& address) -> int {
+        int fd;
+        auto colon = address.rfind(':');
+        if (colon != std::string::npos && address.find('/') == std::string::npos) {
+            auto port = race::parsePort(std::string_view(address).substr(colon + 1));
+            if (!port) {
+                fmt::println(std::cerr, "invalid port in {}, expected host:port with a port from 1 to 65535", address);
+                return -1;
+            }
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(*port);
+            if (inet_pton(AF_INET, address.substr(0, colon).c_str(), &addr.sin_addr) != 1)
+                return -1;
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (fd < 0) {
+                fmt::println(std::cerr, "socket: {}", std::strerror(errno));
+                return -1;
+            }
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close(fd);
+                return -1;
+            }
+        } else {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (address.size() >= sizeof(addr.sun_path)) return -1;
+            std::memcpy(addr.sun_path, address.c_str(), address.size() + 1);
+            unlink(address.c_str());
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (fd < 0) {
+                fmt::println(std::cerr, "socket: {}", std::strerror(errno));
+                return -1;
+            }
+            if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close(fd);
+                return -1;
+            }
+        }
+        if (listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    class Server {
+        Settings const& settings;
+        int epollFd;
+        int listenFd;
+        std::ofstream results;
+        std::unordered_map<int, Connection> connections;
+        std::unordered_map<std::uint32_t, Session> sessions;
+        std::size_t messagesIn = 0;
+        std::size_t messagesOut = 0;
+        std::size_t gamesWritten = 0;
+        std::size_t peakConnections = 0;
+
+        auto watch(Connection const& connection, bool wantWrite) {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? EPOLLOUT : 0u);
+            event.data.fd = connection.fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        }
+
+        auto flush(Connection& connection) {
+            while (!connection.out.empty()) {
+                auto sent = send(connection.fd, connection.out.data(), connection.out.size(), MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    connection.out.clear();
+                    return;
+                }
+                connection.out.erase(connection.out.begin(), connection.out.begin() + sent);
+            }
+            bool writable = connection.out.empty();
+            if (writable != connection.writable) {
+                connection.writable = writable;
+                watch(connection, !writable);
+            }
+        }
+
+        auto queue(Connection& connection, std::uint8_t const* data, std::size_t size) {
+            connection.out.insert(connection.out.end(), data, data + size);
+            messagesOut++;
+            if (connection.writable) flush(connection);
+        }
+
+        auto accept() {
+            while (true) {
+                int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+                if (fd < 0) return;
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLRDHUP;
+                event.data.fd = fd;
+                epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+                connections.emplace(fd, Connection{fd, {}, {}, 0, 0, {}, false, true});
+                peakConnections = std::max(peakConnections, connections.size());
+            }
+        }
+
+        auto leaveSession(Connection& connection) {
+            if (!connection.joined) return;
+            auto session = sessions.find(connection.session);
+            std::erase(session->second.members, connection.fd);
+            if (session->second.members.empty())
+                sessions.erase(session);
+            connection.joined = false;
+        }
+
+        auto drop(int fd) {
+            auto& connection = connections.at(fd);
+            leaveSession(connection);
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            connections.erase(fd);
+        }
+
+        auto onJoin(Connection& connection, race::Join const& join) {
+            leaveSession(connection);
+            auto [session, created] = sessions.try_emplace(join.session, Session{my_library::splitMix64(settings.seed ^ join.session), 0, {}});
+            connection.session = join.session;
+            connection.player = session->second.nextPlayer++;
+            connection.nickname = join.nickname.empty() ? fmt::format("Racer{}", connection.player) : join.nickname;
+            connection.joined = true;
+            session->second.members.push_back(connection.fd);
+
+            std::array<std::uint8_t, race::welcomeSize> message{};
+            race::encode(race::Welcome{connection.player, session->second.seed, settings.speed, settings.maxFreq}, message.data());
+            queue(connection, message.data(), message.size());
+        }
+
+        auto onProgress(Connection& connection, race::Progress progress) {
+            if (!connection.joined) return;
+            progress.player = connection.player;
+
+            std::array<std::uint8_t, race::progressSize> message{};
+            race::encode(progress, message.data());
+            for (int member : sessions.at(connection.session).members) {
+                if (member != connection.fd)
+                    queue(connections.at(member), message.data(), message.size());
+            }
+
+            if (progress.finished) {
+                auto game = Game(connection.nickname, static_cast<int>(progress.score), progress.wpm, settings.speed, settings.maxFreq,
+                                 static_cast<float>(progress.elapsedMs) / 1000.0f, today());
+                game.saveScoreToFile(results);
+                gamesWritten++;
+            }
+        }
+
+        // Returns false when the peer has to be dropped
+        auto onReadable(Connection& connection) -> bool {
+            std::array<std::uint8_t, 4096> chunk{};
+            bool open = true;
+            while (open) {
+                auto received = recv(connection.fd, chunk.data(), chunk.size(), 0);
+                if (received == 0) open = false;
+                if (received < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    return false;
+                }
+                connection.in.insert(connection.in.end(), chunk.begin(), chunk.begin() + received);
+            }
+
+            std::size_t offset = 0;
+            while (offset < connection.in.size()) {
+                auto size = race::messageSize(connection.in[offset]);
+                if (size == 0) return false;
+                if (connection.in.size() - offset < size) break;
+
+                auto const* data = connection.in.data() + offset;
+                switch (static_cast<race::MessageType>(*data)) {
+                    case race::MessageType::Join: onJoin(connection, race::decodeJoin(data)); break;
+                    case race::MessageType::Progress:
+                    case race::MessageType::Finish: onProgress(connection, race::decodeProgress(data)); break;
+                    case race::MessageType::Welcome: return false;
+                }
+                messagesIn++;
+                offset += size;
+            }
+            connection.in.erase(connection.in.begin(), connection.in.begin() + static_cast<std::ptrdiff_t>(offset));
+            return open;
+        }
+
+    public:
+        Server(Settings const& settings, int listenFd)
+        : settings(settings), epollFd(epoll_create1(0)), listenFd(listenFd), results(settings.results, std::ios::out | std::ios::app) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = listenFd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+        }
+
+        ~Server() {
+            for (auto& [fd, connection] : connections)
+                close(fd);
+            close(epollFd);
+        }
+
+        auto connectionCount() const { return connections.size(); }
+
+        // One pass of the event loop, waits at most timeoutMs
+        auto poll(int timeoutMs) {
+            std::array<epoll_event, 256> events{};
+            int count = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMs);
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    accept();
+                    continue;
+                }
+
+                auto iter = connections.find(fd);
+                if (iter == connections.end()) continue;
+
+                bool alive = !(events[i].events & EPOLLERR);
+                if (alive && (events[i].events & EPOLLOUT))
+                    flush(iter->second);
+                if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+                    alive = onReadable(iter->second);
+                if (!alive)
+                    drop(fd);
+            }
+        }
+
+        auto printStats(std::chrono::duration<double> elapsed) const {
+            fmt::println(std::cout, "peak connections: {}, messages in: {}, messages out: {}, games written: {}, {:.2f}s",
+                         peakConnections, messagesIn, messagesOut, gamesWritten, elapsed.count());
+        }
+    };
+
+    // Simulated participants, each one types words at its own pace until it wins or misses 10 words
+    auto simulateClients(Settings const& settings, std::atomic<bool>& done) {
+        struct Racer {
+            race::Client client;
+            race::Progress progress;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point next;
+            double wordsPerSecond;
+            double missChance;
+        };
+
+        my_library::RngService rng(settings.seed);
+        auto& gen = rng.stream(my_library::RngStream::Bots);
+        std::vector<std::unique_ptr<Racer>> racers;
+        for (int i = 0; i < settings.simulatedClients; ++i) {
+            auto racer = std::make_unique<Racer>();
+            if (!racer->client.connect(settings.address)) {
+                fmt::println(std::cerr, "simulated client {} could not connect", i);
+                continue;
+            }
+            auto session = static_cast<std::uint32_t>(i / settings.playersPerSession);
+            auto welcome = racer->client.join(session, fmt::format("Bot{}", i));
+            if (!welcome) continue;
+
+            racer->progress.player = welcome->player;
+            racer->start = racer->next = std::chrono::steady_clock::now();
+            racer->wordsPerSecond = std::uniform_real_distribution<>(5.0, 20.0)(gen);
+            racer->missChance = std::uniform_real_distribution<>(0.0, 0.2)(gen);
+            racers.push_back(std::move(racer));
+        }
+
+        std::size_t active = racers.size();
+        while (active > 0) {
+            auto now = std::chrono::steady_clock::now();
+            for (auto& racer : racers) {
+                if (racer->progress.finished || now < racer->next) continue;
+
+                auto& progress = racer->progress;
+                if (std::bernoulli_distribution(racer->missChance)(gen))
+                    progress.missed++;
+                else
+                    progress.wordsFinished++;
+
+                auto elapsed = std::chrono::duration<float>(now - racer->start).count();
+                progress.elapsedMs = static_cast<std::uint32_t>(elapsed * 1000);
+                progress.wpm = static_cast<std::uint16_t>(elapsed > 0 ? progress.wordsFinished / elapsed * 60 : 0);
+                progress.score = static_cast<std::uint32_t>(progress.wordsFinished * static_cast<int>(progress.wpm * settings.speed * settings.maxFreq * 0.02f));
+                progress.finished = progress.missed == 10 || progress.wordsFinished == 100;
+
+                racer->client.sendProgress(progress);
+                racer->client.poll();
+                if (progress.finished) {
+                    racer->client.disconnect();
+                    active--;
+                }
+                racer->next = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / racer->wordsPerSecond));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done = true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+
+        if (arg == "--listen") settings.address = next();
+        else if (arg == "--results") settings.results = next();
+        else if (arg == "--seed") settings.seed = std::stoull(next());
+        else if (arg == "--speed") settings.speed = static_cast<std::uint8_t>(std::clamp(std::stoi(next()), 1, 10));
+        else if (arg == "--max-freq") settings.maxFreq = static_cast<std::uint8_t>(std::clamp(std::stoi(next()), 5, 10));
+        else if (arg == "--simulate") settings.simulatedClients = std::stoi(next());
+        else if (arg == "--players") settings.playersPerSession = std::max(1, std::stoi(next()));
+        else {
+            fmt::println(std::cerr, "usage: {} [--listen path|host:port] [--results file] [--seed n] [--speed 1-10] [--max-freq 5-10] "
+                                    "[--simulate clients] [--players per-session]", argv[0]);
+            return 1;
+        }
+    }
+
+    int listenFd = listenOn(settings.address);
+    if (listenFd < 0) {
+        fmt::println(std::cerr, "cannot listen on {}", settings.address);
+        return 1;
+    }
+
+    std::signal(SIGINT, [](int) { running = 0; });
+    std::signal(SIGTERM, [](int) { running = 0; });
+
+    Server server(settings, listenFd);
+    fmt::println(std::cout, "race server on {}, seed {}", settings.address, settings.seed);
+
+    auto start = std::chrono::steady_clock::now();
+    if (settings.simulatedClients > 0) {
+        std::atomic<bool> clientsDone = false;
+        std::jthread clients(simulateClients, std::cref(settings), std::ref(clientsDone));
+        while (running && !(clientsDone && server.connectionCount() == 0))
+            server.poll(10);
+    } else {
+        while (running)
+            server.poll(100);
+    }
+
+    server.printStats(std::chrono::steady_clock::now() - start);
+    close(listenFd);
+    if (settings.address.find('/') != std::string::npos)
+        unlink(settings.address.c_str());
+    return 0;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <utility>
+
+namespace my_library {
+    constexpr auto splitMix64(std::uint64_t x) -> std::uint64_t {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // xoshiro256** (Blackman and Vigna), a few cycles per number and usable with the <random> distributions
+    class Xoshiro256 {
+        std::array<std::uint64_t, 4> state{};
+
+        static constexpr auto rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    public:
+        using result_type = std::uint64_t;
+
+        static constexpr auto min() -> result_type { return 0; }
+        static constexpr auto max() -> result_type { return std::numeric_limits<result_type>::max(); }
+
+        // Seeded through splitmix64, so similar seeds still give unrelated sequences
+        explicit constexpr Xoshiro256(std::uint64_t seed = 0) {
+            for (std::size_t i = 0; i < state.size(); ++i)
+                state[i] = splitMix64(seed + i * 0x9e3779b97f4a7c15ULL);
+        }
+
+        constexpr auto operator()() -> result_type {
+            auto result = rotl(state[1] * 5, 7) * 9;
+            auto t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+
+        // Advances by 2^128 numbers, generators jumped a different number of times never overlap
+        constexpr auto jump() {
+            constexpr std::array<std::uint64_t, 4> polynomial = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+            std::array<std::uint64_t, 4> jumped{};
+            for (auto word : polynomial) {
+                for (int bit = 0; bit < 64; ++bit) {
+                    if (word & (std::uint64_t{1} << bit)) {
+                        for (std::size_t i = 0; i < state.size(); ++i)
+                            jumped[i] ^= state[i];
+                    }
+                    (*this)();
+                }
+            }
+            state = jumped;
+        }
+
+        // Uniform in [0, bound) by Lemire's multiply-shift, the division only runs for the rare rejected draws
+        constexpr auto below(std::uint32_t bound) -> std::uint32_t {
+            auto product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+            auto low = static_cast<std::uint32_t>(product);
+            if (low < bound) {
+                auto threshold = static_cast<std::uint32_t>(-bound) % bound;
+                while (low < threshold) {
+                    product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+                    low = static_cast<std::uint32_t>(product);
+                }
+            }
+            return static_cast<std::uint32_t>(product >> 32);
+        }
+
+        // Uniform in [from, to]
+        constexpr auto between(int from, int to) -> int {
+            return from + static_cast<int>(below(static_cast<std::uint32_t>(to - from) + 1));
+        }
+
+        template<typename Range>
+        constexpr auto shuffle(Range& range) {
+            auto first = std::begin(range);
+            auto size = static_cast<std::uint32_t>(std::size(range));
+            for (std::uint32_t i = size; i > 1; --i)
+                std::iter_swap(first + (i - 1), first + below(i));
+        }
+    };
+
+    enum class RngStream {
+        Shuffle,    // Word order
+        SpawnY,     // Lines new and returning words appear on
+        Bots,       // Simulated players
+        Names,      // Guest nicknames, drawn outside of any game
+        Count,
+    };
+
+    // One seed per game, every use of randomness draws from its own stream of it,
+    // so drawing more in one place never changes the sequence of another
+    class RngService {
+        std::uint64_t currentSeed = 0;
+        std::array<Xoshiro256, static_cast<std::size_t>(RngStream::Count)> streams;
+
+    public:
+        explicit RngService(std::uint64_t seed = freshSeed()) { reseed(seed); }
+
+        // The only place touching std::random_device, once per game
+        static auto freshSeed() -> std::uint64_t {
+            std::random_device device;
+            return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+        }
+
+        auto reseed(std::uint64_t seed) -> void {
+            currentSeed = seed;
+            Xoshiro256 generator(seed);
+            for (auto& stream : streams) {
+                stream = generator;
+                generator.jump();
+            }
+        }
+
+        auto seed() const { return currentSeed; }
+
+        auto stream(RngStream which) -> Xoshiro256& { return streams[static_cast<std::size_t>(which)]; }
+    };
+}
@@ -0,0 +1,93 @@
+// Merges the scores files of several machines into one store without duplicates, best score first,
+// and prints the global top K. Memory use is bounded by --memory, whatever the size of the inputs.
+#include "score_merge.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    std::vector<std::string> presortedFiles;
+    std::string output;
+    std::string topOutput;
+    std::string tempDir = std::filesystem::temp_directory_path().string();
+    std::size_t memoryMb = 256;
+    std::size_t topK = 10;
+    bool presorted = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+
+        if (arg == "--out") output = next();
+        else if (arg == "--top") topK = std::stoul(next());
+        else if (arg == "--top-out") topOutput = next();
+        else if (arg == "--memory") memoryMb = std::stoul(next());
+        else if (arg == "--temp") tempDir = next();
+        else if (arg == "--presorted") presorted = true;        // Applies to the files after it
+        else if (!arg.starts_with("--")) (presorted ? presortedFiles : files).push_back(arg);
+        else output.clear();
+    }
+
+    if (output.empty() || files.size() + presortedFiles.size() == 0) {
+        fmt::println(std::cerr, "usage: {} --out merged.txt [--top K] [--top-out top.txt] [--memory MB] [--temp dir] "
+                                "scores.txt... [--presorted sorted.txt...]", argv[0]);
+        return 1;
+    }
+
+    my_library::ScoreMerger merger(tempDir, memoryMb << 20);
+    for (auto const& file : files) {
+        if (!merger.addFile(file)) {
+            fmt::println(std::cerr, "Cannot read {}", file);
+            return 1;
+        }
+    }
+    for (auto const& file : presortedFiles) {
+        if (!std::filesystem::exists(file)) {
+            fmt::println(std::cerr, "Cannot read {}", file);
+            return 1;
+        }
+        merger.addPresorted(file);
+    }
+
+    // Written next to the output and renamed over it only once the merge succeeded
+    auto temporary = output + ".tmp";
+    std::vector<std::string> top;
+    my_library::ScoreMergeStats stats;
+    {
+        std::ofstream outfile(temporary);
+        stats = merger.merge(outfile, topK, [&](my_library::ScoreRecord const& record) { top.push_back(record.line); });
+        if (!outfile) {
+            fmt::println(std::cerr, "Cannot write {}", output);
+            std::filesystem::remove(temporary);
+            return 1;
+        }
+    }
+    if (stats.unsortedInput) {
+        fmt::println(std::cerr, "A file given after --presorted is not sorted by score, merge it without --presorted");
+        std::filesystem::remove(temporary);
+        return 1;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, output, error);
+    if (error) {
+        fmt::println(std::cerr, "Cannot write {}: {}", output, error.message());
+        std::filesystem::remove(temporary, error);
+        return 1;
+    }
+
+    std::ofstream topFile;
+    if (!topOutput.empty())
+        topFile.open(topOutput);
+    std::ostream& topOut = topOutput.empty() ? std::cout : topFile;
+    for (auto const& line : top)
+        fmt::println(topOut, "{}", line);
+
+    fmt::println(std::cerr, "{} records read, {} invalid, {} duplicates, {} written to {} ({} sorted runs)",
+                 stats.read, stats.invalid, stats.duplicates, stats.written, output, stats.runs);
+    return 0;
+}
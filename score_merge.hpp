@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace my_library {
+    // One line of a scores file as Game::saveScoreToFile writes it, ordered by score (best first),
+    // then by the whole line, so identical records from re-synced files end up next to each other
+    struct ScoreRecord {
+        int score;
+        std::string line;
+
+        auto operator<(ScoreRecord const& other) const {
+            return score != other.score ? score > other.score : line < other.line;
+        }
+    };
+
+    inline auto parseScoreRecord(std::string line) -> std::optional<ScoreRecord> {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        std::string_view view(line);
+        auto nicknameEnd = view.find(' ');
+        if (nicknameEnd == std::string_view::npos || nicknameEnd == 0)
+            return std::nullopt;
+        auto scoreText = view.substr(nicknameEnd + 1);
+        int score;
+        auto [end, error] = std::from_chars(scoreText.data(), scoreText.data() + scoreText.size(), score);
+        if (error != std::errc() || end == scoreText.data() || (end != scoreText.data() + scoreText.size() && *end != ' '))
+            return std::nullopt;
+        return ScoreRecord{score, std::move(line)};
+    }
+
+    struct ScoreMergeStats {
+        std::uint64_t read = 0;
+        std::uint64_t invalid = 0;
+        std::uint64_t duplicates = 0;
+        std::uint64_t written = 0;
+        std::size_t runs = 0;
+        bool unsortedInput = false;     // A file given as pre-sorted was not
+    };
+
+    // External merge of score files: unsorted files are cut into sorted runs of bounded size on disk,
+    // runs and pre-sorted files are then merged through a heap of one record per file, at most fanIn files at a time
+    class ScoreMerger {
+        std::filesystem::path tempDir;
+        std::size_t runBytes;
+        std::size_t fanIn;
+        std::string runPrefix;
+        std::vector<std::filesystem::path> runs;
+        std::vector<std::filesystem::path> presorted;
+        std::vector<std::filesystem::path> temporaries;
+        ScoreMergeStats stats;
+
+        auto newTemporary() {
+            auto path = tempDir / (runPrefix + std::to_string(temporaries.size()) + ".run");
+            temporaries.push_back(path);
+            return path;
+        }
+
+        auto writeRun(std::vector<ScoreRecord>& records) {
+            std::sort(records.begin(), records.end());
+            auto path = newTemporary();
+            std::ofstream outfile(path);
+            for (auto const& record : records)
+                outfile << record.line << '\n';
+            runs.push_back(path);
+            stats.runs++;
+            records.clear();
+        }
+
+        // Streams the records of all inputs in order, equal records are passed on as they come.
+        // Pre-sorted inputs are counted and checked here, runs were counted when they were cut.
+        auto mergeFiles(std::vector<std::filesystem::path> const& inputs, std::vector<bool> const& isPresorted,
+                        std::function<void(ScoreRecord&&)> const& sink) {
+            struct Head {
+                ScoreRecord record;
+                std::size_t input;
+            };
+            auto later = [](Head const& a, Head const& b) { return b.record < a.record; };
+            std::vector<Head> heap;
+            heap.reserve(inputs.size());
+
+            std::vector<std::ifstream> files;
+            files.reserve(inputs.size());
+            auto next = [&](std::size_t input) -> std::optional<ScoreRecord> {
+                std::string line;
+                while (std::getline(files[input], line)) {
+                    if (isPresorted[input]) stats.read++;
+                    if (auto record = parseScoreRecord(std::move(line)))
+                        return record;
+                    if (isPresorted[input]) stats.invalid++;
+                }
+                return std::nullopt;
+            };
+
+            for (std::size_t input = 0; input < inputs.size(); ++input) {
+                files.emplace_back(inputs[input]);
+                if (auto record = next(input))
+                    heap.push_back({std::move(*record), input});
+            }
+            std::ranges::make_heap(heap, later);
+
+            while (!heap.empty()) {
+                std::ranges::pop_heap(heap, later);
+                auto head = std::move(heap.back());
+                heap.pop_back();
+                if (auto record = next(head.input)) {
+                    if (isPresorted[head.input] && *record < head.record)
+                        stats.unsortedInput = true;
+                    heap.push_back({std::move(*record), head.input});
+                    std::ranges::push_heap(heap, later);
+                }
+                sink(std::move(head.record));
+            }
+        }
+
+    public:
+        explicit ScoreMerger(std::filesystem::path tempDir = std::filesystem::temp_directory_path(),
+                             std::size_t memoryBytes = std::size_t{256} << 20, std::size_t fanIn = 64)
+        : tempDir(std::move(tempDir)), runBytes(std::max<std::size_t>(memoryBytes, 1 << 20)), fanIn(std::max<std::size_t>(fanIn, 2)),
+          runPrefix("score_merge_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_") { }
+
+        ScoreMerger(ScoreMerger const&) = delete;
+        auto operator=(ScoreMerger const&) -> ScoreMerger& = delete;
+
+        ~ScoreMerger() {
+            std::error_code error;
+            for (auto const& path : temporaries)
+                std::filesystem::remove(path, error);
+        }
+
+        // Pre-sorted files (for example an earlier merge result) are merged as they are
+        auto addPresorted(std::filesystem::path const& path) {
+            presorted.push_back(path);
+        }
+
+        // Any other file is sorted into runs right away, holding about memoryBytes of records at a time
+        auto addFile(std::filesystem::path const& path) -> bool {
+            std::ifstream infile(path);
+            if (!infile) return false;
+
+            std::vector<ScoreRecord> records;
+            std::size_t bytes = 0;
+            std::string line;
+            while (std::getline(infile, line)) {
+                stats.read++;
+                auto size = line.size() + sizeof(ScoreRecord);
+                auto record = parseScoreRecord(std::move(line));
+                if (!record) {
+                    stats.invalid++;
+                    continue;
+                }
+                records.push_back(std::move(*record));
+                bytes += size;
+                if (bytes >= runBytes) {
+                    writeRun(records);
+                    bytes = 0;
+                }
+            }
+            if (!records.empty())
+                writeRun(records);
+            return true;
+        }
+
+        // Writes every distinct record once, best score first, and hands the first topK of them to top
+        auto merge(std::ostream& out, std::size_t topK = 0, std::function<void(ScoreRecord const&)> const& top = {}) -> ScoreMergeStats {
+            auto inputs = runs;
+            std::vector<bool> isPresorted(runs.size(), false);
+            inputs.insert(inputs.end(), presorted.begin(), presorted.end());
+            isPresorted.resize(inputs.size(), true);
+
+            // Intermediate passes while there are more files than merged at once, pre-sorted files are
+            // checked and counted in the pass that reads them, and only the runs are removed after it
+            while (inputs.size() > fanIn) {
+                auto groupEnd = static_cast<std::ptrdiff_t>(fanIn);
+                std::vector<std::filesystem::path> group(inputs.begin(), inputs.begin() + groupEnd);
+                std::vector<bool> groupPresorted(isPresorted.begin(), isPresorted.begin() + groupEnd);
+                inputs.erase(inputs.begin(), inputs.begin() + groupEnd);
+                isPresorted.erase(isPresorted.begin(), isPresorted.begin() + groupEnd);
+
+                auto path = newTemporary();
+                std::ofstream outfile(path);
+                mergeFiles(group, groupPresorted, [&](ScoreRecord&& record) { outfile << record.line << '\n'; });
+                outfile.close();
+                inputs.push_back(path);
+                isPresorted.push_back(false);
+
+                std::error_code error;
+                for (std::size_t i = 0; i < group.size(); ++i) {
+                    if (!groupPresorted[i])
+                        std::filesystem::remove(group[i], error);
+                }
+            }
+
+            std::optional<ScoreRecord> previous;
+            mergeFiles(inputs, isPresorted, [&](ScoreRecord&& record) {
+                if (previous && previous->line == record.line) {
+                    stats.duplicates++;
+                    return;
+                }
+                out << record.line << '\n';
+                if (stats.written++ < topK && top)
+                    top(record);
+                previous = std::move(record);
+            });
+            out.flush();
+            return stats;
+        }
+    };
+}
@@ -0,0 +1,241 @@
+// Headless batch simulator for tuning difficulty and scoring.
+// Plays many games per (wordSpeed, maxWordFrequency, typist) cell with the rules of main.cpp
+// and writes score and survival distributions of every cell as CSV.
+#include "rng.hpp"
+#include "words.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace {
+    struct Settings {
+        int gamesPerCell = 1000;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        float fps = 60;             // Words move wordSpeed pixels per frame
+        float charWidth = 12;       // Average glyph advance of the interface font at size 24
+        float screenWidth = 800;
+        std::uint64_t seed = 1;
+        std::vector<int> speeds = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};    // wordSpeed * 100
+        std::vector<int> maxFreqs = {5, 6, 7, 8, 9, 10};              // maxWordFrequency * 10
+        std::vector<int> typistWpms = {30, 50, 70, 90};
+        std::string output;
+    };
+
+    // Modeled player: types at a mean speed, needs time to react to a word and sometimes mistypes
+    struct Typist {
+        float charsPerSecond;
+        float errorChance;      // Chance of retyping a word after a typo
+    };
+
+    struct Cell {
+        int speed;
+        int maxFreq;
+        int typistWpm;
+    };
+
+    struct Outcome {
+        int score;
+        float survival;
+        int wordsFinished;
+        bool won;
+    };
+
+    struct OnScreenWord {
+        std::size_t word;
+        float deadline;     // Time at which it leaves the screen
+    };
+
+    // Event-driven replay of the game loop: word spawns, typed words and missed words
+    auto simulateGame(Cell const& cell, Settings const& settings, std::vector<int>& lengths, my_library::Xoshiro256& gen) -> Outcome {
+        float wordSpeed = static_cast<float>(cell.speed) / 100.0f;
+        float maxWordFrequency = static_cast<float>(cell.maxFreq) / 10.0f;
+        float pixelsPerSecond = wordSpeed * settings.fps;
+
+        std::normal_distribution<float> wpmDistribution(static_cast<float>(cell.typistWpm), static_cast<float>(cell.typistWpm) * 0.15f);
+        std::normal_distribution<float> reactionDistribution(0.35f, 0.1f);
+        Typist typist{std::max(5.0f, wpmDistribution(gen)) * 5.0f / 60.0f, 0.05f};
+        std::bernoulli_distribution mistype(typist.errorChance);
+
+        gen.shuffle(lengths);
+        auto crossingTime = [&](std::size_t word) {
+            return (settings.screenWidth + static_cast<float>(lengths[word]) * settings.charWidth) / pixelsPerSecond;
+        };
+
+        std::vector<OnScreenWord> onScreen;
+        std::size_t nextWord = 0;
+        float wordFrequency = 1.0f;
+        float nextSpawn = wordFrequency;
+        float time = 0;
+        int wordsFinished = 0;
+        int missedCount = 0;
+        int score = 0;
+
+        bool typing = false;
+        std::size_t target = 0;
+        float typedAt = 0;
+
+        while (true) {
+            // Typist starts on the word closest to leaving the screen
+            if (!typing && !onScreen.empty()) {
+                auto urgent = std::ranges::min_element(onScreen, {}, &OnScreenWord::deadline);
+                target = urgent->word;
+                auto keystrokes = static_cast<float>(lengths[target] + 1);
+                if (mistype(gen))
+                    keystrokes += static_cast<float>(lengths[target] + 1);
+                typedAt = time + std::max(0.05f, reactionDistribution(gen)) + keystrokes / typist.charsPerSecond;
+                typing = true;
+            }
+
+            float nextMiss = onScreen.empty() ? INFINITY : std::ranges::min_element(onScreen, {}, &OnScreenWord::deadline)->deadline;
+            float nextSpawnEvent = nextWord < lengths.size() ? nextSpawn : INFINITY;
+            float nextTyped = typing ? typedAt : INFINITY;
+            time = std::min({nextMiss, nextSpawnEvent, nextTyped});
+
+            if (time == nextTyped) {
+                int wpm = static_cast<int>(static_cast<float>(wordsFinished) / time * 60);
+                score = wordsFinished * static_cast<int>(static_cast<float>(wpm) * wordSpeed * maxWordFrequency * 20);
+                std::erase_if(onScreen, [&](OnScreenWord const& word) { return word.word == target; });
+                wordsFinished++;
+                typing = false;
+                if (wordsFinished == static_cast<int>(lengths.size()))
+                    return {score, time, wordsFinished, true};
+            } else if (time == nextMiss) {
+                // Missed words come back from the left, typing can still finish them
+                auto missed = std::ranges::min_element(onScreen, {}, &OnScreenWord::deadline);
+                missed->deadline = time + crossingTime(missed->word);
+                if (++missedCount == 10)
+                    return {score, time, wordsFinished, false};
+            } else {
+                onScreen.push_back({nextWord, time + crossingTime(nextWord)});
+                nextWord++;
+                wordFrequency = std::max(wordFrequency - 0.05f, maxWordFrequency);
+                nextSpawn = time + wordFrequency;
+            }
+        }
+    }
+
+    auto percentile(std::vector<float> values, float fraction) -> float {
+        if (values.empty()) return 0;
+        auto index = static_cast<std::size_t>(fraction * static_cast<float>(values.size() - 1));
+        std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(index));
+        return values[index];
+    }
+
+    auto parseList(std::string const& text) {
+        std::vector<int> values;
+        std::istringstream iss(text);
+        std::string value;
+        while (std::getline(iss, value, ','))
+            values.push_back(std::stoi(value));
+        return values;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : "0"; };
+
+        if (arg == "--games") settings.gamesPerCell = std::max(1, std::stoi(next()));
+        else if (arg == "--threads") settings.threads = std::max(1, std::stoi(next()));
+        else if (arg == "--fps") settings.fps = std::stof(next());
+        else if (arg == "--char-width") settings.charWidth = std::stof(next());
+        else if (arg == "--seed") settings.seed = std::stoull(next());
+        else if (arg == "--speeds") settings.speeds = parseList(next());
+        else if (arg == "--max-freqs") settings.maxFreqs = parseList(next());
+        else if (arg == "--wpms") settings.typistWpms = parseList(next());
+        else if (arg == "--out") settings.output = next();
+        else {
+            fmt::println(std::cerr, "usage: {} [--games per-cell] [--threads n] [--fps n] [--char-width px] [--seed n] "
+                                    "[--speeds 1,2,..] [--max-freqs 5,6,..] [--wpms 30,50,..] [--out file.csv]", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Cell> cells;
+    for (int speed : settings.speeds)
+        for (int maxFreq : settings.maxFreqs)
+            for (int wpm : settings.typistWpms)
+                cells.push_back({speed, maxFreq, wpm});
+
+    std::vector<int> wordLengths;
+    for (auto const& word : builtInWords)
+        wordLengths.push_back(word.length);
+
+    // Every cell is split into fixed-size batches, threads claim the next batch until none are left,
+    // so cheap cells (fast words, early game over) never leave a thread idle
+    constexpr int batchSize = 250;
+    int batchesPerCell = (settings.gamesPerCell + batchSize - 1) / batchSize;
+    std::size_t batchCount = cells.size() * static_cast<std::size_t>(batchesPerCell);
+    std::vector<std::vector<Outcome>> outcomes(cells.size(), std::vector<Outcome>(static_cast<std::size_t>(settings.gamesPerCell)));
+    std::atomic<std::size_t> nextBatch = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned t = 0; t < settings.threads; ++t) {
+            workers.emplace_back([&] {
+                auto lengths = wordLengths;
+                for (auto batch = nextBatch++; batch < batchCount; batch = nextBatch++) {
+                    auto cell = batch / static_cast<std::size_t>(batchesPerCell);
+                    auto first = static_cast<int>(batch % static_cast<std::size_t>(batchesPerCell)) * batchSize;
+                    auto last = std::min(first + batchSize, settings.gamesPerCell);
+
+                    // Seeded per batch, results do not depend on the thread count
+                    my_library::Xoshiro256 gen(my_library::splitMix64(settings.seed) + batch);
+                    for (int game = first; game < last; ++game) {
+                        std::ranges::copy(wordLengths, lengths.begin());
+                        outcomes[cell][static_cast<std::size_t>(game)] = simulateGame(cells[cell], settings, lengths, gen);
+                    }
+                }
+            });
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::ofstream outfile;
+    if (!settings.output.empty())
+        outfile.open(settings.output);
+    std::ostream& out = settings.output.empty() ? std::cout : outfile;
+
+    fmt::println(out, "speed,max_freq,typist_wpm,games,win_rate,score_mean,score_p10,score_p50,score_p90,"
+                      "survival_mean,survival_p10,survival_p50,survival_p90,words_mean");
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        std::vector<float> scores;
+        std::vector<float> survivals;
+        double wins = 0;
+        double words = 0;
+        for (auto const& outcome : outcomes[i]) {
+            scores.push_back(static_cast<float>(outcome.score));
+            survivals.push_back(outcome.survival);
+            wins += outcome.won;
+            words += outcome.wordsFinished;
+        }
+
+        auto games = static_cast<double>(outcomes[i].size());
+        auto mean = [&](std::vector<float> const& values) { return std::accumulate(values.begin(), values.end(), 0.0) / games; };
+        fmt::println(out, "{},{},{},{},{:.4f},{:.1f},{:.0f},{:.0f},{:.0f},{:.2f},{:.2f},{:.2f},{:.2f},{:.1f}",
+                     cells[i].speed, cells[i].maxFreq, cells[i].typistWpm, outcomes[i].size(), wins / games,
+                     mean(scores), percentile(scores, 0.1f), percentile(scores, 0.5f), percentile(scores, 0.9f),
+                     mean(survivals), percentile(survivals, 0.1f), percentile(survivals, 0.5f), percentile(survivals, 0.9f), words / games);
+    }
+
+    auto totalGames = static_cast<double>(cells.size()) * settings.gamesPerCell;
+    fmt::println(std::cerr, "{} games in {:.2f}s on {} threads ({:.0f} games/s)",
+                 totalGames, elapsed.count(), settings.threads, totalGames / elapsed.count());
+    return 0;
+}
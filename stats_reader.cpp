@@ -0,0 +1,114 @@
+// Reads the live stats blocks published by running games.
+// StatsReader [pid] [--watch ms] prints one line per game, --watch repeats it every ms milliseconds.
+#include "live_stats.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    auto runningGames() {
+        std::vector<long> pids;
+        std::error_code error;
+        for (auto const& entry : std::filesystem::directory_iterator("/dev/shm", error)) {
+            auto name = entry.path().filename().string();
+            if (!name.starts_with("stantyper-"))
+                continue;
+            // Anything else with the prefix is not a game's block
+            long pid;
+            auto digits = std::string_view(name).substr(10);
+            auto [end, parseError] = std::from_chars(digits.data(), digits.data() + digits.size(), pid);
+            if (parseError == std::errc() && end == digits.data() + digits.size())
+                pids.push_back(pid);
+        }
+        std::ranges::sort(pids);
+        return pids;
+    }
+
+    auto printGame(long pid) -> bool {
+        auto name = live_stats::blockName(pid);
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            fmt::println(std::cerr, "{}: no live stats", pid);
+            return false;
+        }
+        // Reading past the end of a shorter object raises SIGBUS, a game between shm_open and ftruncate has size 0
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(live_stats::Block))) {
+            close(fd);
+            fmt::println(std::cerr, "{}: unreadable live stats", pid);
+            return false;
+        }
+        void* mapping = mmap(nullptr, sizeof(live_stats::Block), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            fmt::println(std::cerr, "{}: cannot map live stats", pid);
+            return false;
+        }
+
+        auto const& block = *static_cast<live_stats::Block const*>(mapping);
+        std::optional<live_stats::Snapshot> snapshot;
+        if (block.magic == live_stats::magic && block.version == live_stats::version)
+            snapshot = live_stats::read(block);
+        bool valid = snapshot.has_value();
+        if (!valid) {
+            fmt::println(std::cerr, "{}: unreadable live stats", pid);
+        } else {
+            auto state = snapshot->gameState < live_stats::gameStateNames.size() ? live_stats::gameStateNames[snapshot->gameState] : "?";
+            fmt::println("{:>8} {:<9} score {:>7}  wpm {:>4}  missed {:>2}  words {:>4}  frame {:>6.2f} ms  input {:>6.2f} ms  #{}{}",
+                         pid, state, snapshot->score, snapshot->wpm, snapshot->missedCount, snapshot->wordsFinished,
+                         snapshot->frameMs, snapshot->inputLatencyMs, snapshot->frame, kill(static_cast<pid_t>(pid), 0) == 0 ? "" : " (exited)");
+        }
+        munmap(mapping, sizeof(live_stats::Block));
+        return valid;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<long> pids;
+    int watchMs = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--watch" && i + 1 < argc) {
+            watchMs = std::max(1, std::stoi(argv[++i]));
+        } else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) {
+            pids.push_back(std::stol(arg));
+        } else {
+            fmt::println(std::cerr, "usage: {} [pid...] [--watch ms]", argv[0]);
+            return 1;
+        }
+    }
+
+    while (true) {
+        auto games = pids.empty() ? runningGames() : pids;
+        if (games.empty())
+            fmt::println(std::cerr, "No running games");
+
+        bool ok = !games.empty();
+        for (auto pid : games)
+            ok = printGame(pid) && ok;
+
+        if (watchMs == 0)
+            return ok ? 0 : 1;
+        fmt::println("");
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    }
+}
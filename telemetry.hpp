@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <fmt/ostream.h>
+
+namespace my_library {
+    // Single producer, single consumer ring, push and pop never block or allocate
+    template<typename T, std::size_t Capacity>
+    class SpscRing {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        std::array<T, Capacity> slots{};
+        alignas(64) std::atomic<std::size_t> head = 0;  // Next slot to pop, written by the consumer
+        alignas(64) std::atomic<std::size_t> tail = 0;  // Next slot to push, written by the producer
+
+    public:
+        // Fails once only reserve free slots are left, so pushes with a smaller reserve still fit
+        auto push(T const& value, std::size_t reserve = 0) -> bool {
+            auto position = tail.load(std::memory_order_relaxed);
+            if (position - head.load(std::memory_order_acquire) >= Capacity - reserve)
+                return false;
+            slots[position & (Capacity - 1)] = value;
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        auto pop() -> std::optional<T> {
+            auto position = head.load(std::memory_order_relaxed);
+            if (position == tail.load(std::memory_order_acquire))
+                return std::nullopt;
+            T value = slots[position & (Capacity - 1)];
+            head.store(position + 1, std::memory_order_release);
+            return value;
+        }
+    };
+
+    struct TelemetryEvent {
+        enum class Type : std::uint8_t {
+            GameStart,
+            Key,
+            Backspace,
+            WrongSubmit,
+            WordSpawned,
+            WordFinished,
+            WordMissed,
+            GameEnd,
+        };
+
+        Type type;
+        std::uint32_t word;
+        float time;     // Seconds since the game started
+    };
+
+    struct TelemetrySummary {
+        int rollingWpm = 0;         // Words finished in the last 10 seconds of the game, per minute
+        int peakRollingWpm = 0;
+        float reactionP50 = 0;      // Seconds from a word appearing until it was typed
+        float reactionP90 = 0;
+        float reactionP99 = 0;
+        float keyIntervalP50 = 0;
+        float errorRate = 0;        // Backspaces and wrong submits per keystroke
+        int keys = 0;
+        int backspaces = 0;
+        int wrongSubmits = 0;
+        int misses = 0;
+        int droppedEvents = 0;
+
+        auto saveToFile(std::ostream& out, std::string const& nickname, std::string const& date) const {
+            fmt::println(out, "{} {} {} {} {:.3f} {:.3f} {:.3f} {:.3f} {:.4f} {} {} {} {}", nickname, date, rollingWpm, peakRollingWpm,
+                         reactionP50, reactionP90, reactionP99, keyIntervalP50, errorRate, keys, backspaces, wrongSubmits, misses);
+            out.flush();
+        }
+    };
+
+    // The game loop records events into a lock-free ring, a worker thread aggregates them
+    // and publishes the summary after GameEnd, the game loop never waits for it
+    class Telemetry {
+        static constexpr float rollingWindow = 10.0f;
+        static constexpr std::size_t lifecycleReserve = 64;    // Slots only GameStart and GameEnd may take
+        static constexpr std::size_t summaryWords = sizeof(TelemetrySummary) / 4;
+        static_assert(std::is_trivially_copyable_v<TelemetrySummary> && sizeof(TelemetrySummary) % 4 == 0,
+                      "The summary is published as 32-bit words");
+
+        SpscRing<TelemetryEvent, 4096> ring;
+        std::atomic<std::uint32_t> wakeups = 0;     // Bumped after every push, the worker sleeps on it while the ring is empty
+        std::atomic<int> dropped = 0;
+        std::uint32_t generation = 0;   // Of the game started last, only the game loop touches it
+        std::uint32_t lostGeneration = 0;   // Game whose GameStart or GameEnd did not fit, only the game loop touches it
+
+        // Seqlock around the published summary, the words are atomics so a torn read is retried, never undefined
+        alignas(64) std::atomic<std::uint32_t> sequence = 0;    // Odd while the worker writes
+        std::atomic<std::uint32_t> publishedGeneration = 0;     // Game the published summary belongs to, 0 for none
+        std::array<std::atomic<std::uint32_t>, summaryWords> published{};
+        std::jthread worker;
+
+        struct Run {
+            std::uint32_t generation = 0;
+            std::unordered_map<std::uint32_t, float> spawnTimes;
+            std::vector<float> reactions;
+            std::vector<float> keyIntervals;
+            std::vector<float> finishTimes;
+            float lastKey = -1;
+            int keys = 0;
+            int backspaces = 0;
+            int wrongSubmits = 0;
+            int misses = 0;
+        };
+
+        static auto percentile(std::vector<float>& values, float fraction) -> float {
+            if (values.empty()) return 0;
+            auto index = static_cast<std::size_t>(fraction * static_cast<float>(values.size() - 1));
+            std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(index));
+            return values[index];
+        }
+
+        auto summarize(Run& run, float endTime) {
+            TelemetrySummary result;
+            auto recent = std::ranges::count_if(run.finishTimes, [&](float time) { return time >= endTime - rollingWindow; });
+            result.rollingWpm = static_cast<int>(static_cast<float>(recent) * 60.0f / std::min(rollingWindow, std::max(endTime, 1.0f)));
+
+            // finishTimes is sorted, slide a window ending at each finish
+            std::size_t first = 0;
+            for (std::size_t last = 0; last < run.finishTimes.size(); ++last) {
+                while (run.finishTimes[first] < run.finishTimes[last] - rollingWindow)
+                    first++;
+                auto window = std::min(rollingWindow, std::max(run.finishTimes[last], 1.0f));
+                result.peakRollingWpm = std::max(result.peakRollingWpm, static_cast<int>(static_cast<float>(last - first + 1) * 60.0f / window));
+            }
+
+            result.reactionP50 = percentile(run.reactions, 0.5f);
+            result.reactionP90 = percentile(run.reactions, 0.9f);
+            result.reactionP99 = percentile(run.reactions, 0.99f);
+            result.keyIntervalP50 = percentile(run.keyIntervals, 0.5f);
+            result.keys = run.keys;
+            result.backspaces = run.backspaces;
+            result.wrongSubmits = run.wrongSubmits;
+            result.misses = run.misses;
+            result.errorRate = run.keys != 0 ? static_cast<float>(run.backspaces + run.wrongSubmits) / static_cast<float>(run.keys) : 0;
+            result.droppedEvents = dropped.exchange(0);
+
+            auto words = std::bit_cast<std::array<std::uint32_t, summaryWords>>(result);
+            auto before = sequence.load(std::memory_order_relaxed);
+            sequence.store(before + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            publishedGeneration.store(run.generation, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < summaryWords; ++i)
+                published[i].store(words[i], std::memory_order_relaxed);
+            sequence.store(before + 2, std::memory_order_release);
+        }
+
+        auto wake() {
+            wakeups.fetch_add(1, std::memory_order_release);
+            wakeups.notify_one();
+        }
+
+        auto consume(std::stop_token const& stop) {
+            std::stop_callback wakeOnStop(stop, [this] { wake(); });
+            Run run;
+            while (!stop.stop_requested()) {
+                // Loaded before the pop, so a push between the pop and the wait ends the wait right away
+                auto seen = wakeups.load(std::memory_order_acquire);
+                auto event = ring.pop();
+                if (!event) {
+                    wakeups.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+
+                switch (event->type) {
+                    case TelemetryEvent::Type::GameStart:
+                        run = Run{};
+                        run.generation = event->word;
+                        break;
+                    case TelemetryEvent::Type::Key:
+                    case TelemetryEvent::Type::Backspace:
+                        if (run.lastKey >= 0)
+                            run.keyIntervals.push_back(event->time - run.lastKey);
+                        run.lastKey = event->time;
+                        run.keys++;
+                        if (event->type == TelemetryEvent::Type::Backspace)
+                            run.backspaces++;
+                        break;
+                    case TelemetryEvent::Type::WrongSubmit:
+                        run.wrongSubmits++;
+                        break;
+                    case TelemetryEvent::Type::WordSpawned:
+                        run.spawnTimes[event->word] = event->time;
+                        break;
+                    case TelemetryEvent::Type::WordFinished:
+                        if (auto spawn = run.spawnTimes.find(event->word); spawn != run.spawnTimes.end())
+                            run.reactions.push_back(event->time - spawn->second);
+                        run.finishTimes.push_back(event->time);
+                        break;
+                    case TelemetryEvent::Type::WordMissed:
+                        run.misses++;
+                        break;
+                    case TelemetryEvent::Type::GameEnd:
+                        summarize(run, event->time);
+                        break;
+                }
+            }
+        }
+
+    public:
+        Telemetry() : worker([this](std::stop_token stop) { consume(stop); }) { }
+
+        // Keystrokes and word events are dropped when the ring is full, GameStart and GameEnd have slots of their own
+        // and only get lost when even those are taken, which lost() then reports
+        auto record(TelemetryEvent::Type type, float time, std::uint32_t word = 0) {
+            bool lifecycle = type == TelemetryEvent::Type::GameStart || type == TelemetryEvent::Type::GameEnd;
+            if (ring.push({type, word, time}, lifecycle ? 0 : lifecycleReserve)) {
+                wake();
+                return;
+            }
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            if (lifecycle)
+                lostGeneration = generation;
+        }
+
+        // GameStart carries the game's generation, a summary of an earlier game is never returned for this one
+        auto start() {
+            record(TelemetryEvent::Type::GameStart, 0, ++generation);
+        }
+
+        // True when the summary of the game started last will never arrive
+        auto lost() const { return lostGeneration == generation && generation != 0; }
+
+        // Summary of the game started last, empty while the worker is still computing it
+        auto result() const -> std::optional<TelemetrySummary> {
+            for (int attempt = 0; attempt < 100; ++attempt) {
+                auto before = sequence.load(std::memory_order_acquire);
+                if (before & 1) continue;
+
+                auto summaryGeneration = publishedGeneration.load(std::memory_order_relaxed);
+                std::array<std::uint32_t, summaryWords> words{};
+                for (std::size_t i = 0; i < summaryWords; ++i)
+                    words[i] = published[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) != before) continue;
+
+                if (summaryGeneration != generation)
+                    return std::nullopt;
+                return std::bit_cast<TelemetrySummary>(words);
+            }
+            return std::nullopt;
+        }
+    };
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+
+// Built-in English words, used unless a word list is given with --words
+inline constexpr std::string_view builtInWordTexts[] = {
+        "apple", "run", "beautiful", "he", "quickly", "and", "under", "wow", "cat", "jump",
+        "tall", "she", "very", "but", "over", "oops", "dog", "eat", "small", "they", "slowly",
+        "because", "in", "hey", "house", "swim", "smart", "we", "happily", "if", "on", "oh",
+        "tree", "walk", "strong", "you", "softly", "or", "with", "ah", "sun", "fly", "kind",
+        "it", "loudly", "while", "at", "ouch", "moon", "sit", "fast", "carefully",
+        "although", "by", "car", "read", "bright", "us", "gently", "unless", "near", "sky",
+        "write", "dark", "him", "eagerly", "since", "of", "star", "sleep", "sweet", "her",
+        "quietly", "though", "between", "ugh", "flower", "sing", "brave", "them", "silently",
+        "whether", "during", "river", "dance", "warm", "me", "yet", "before", "hooray", "grass",
+        "talk", "cold", "this", "really", "after", "behind", "hill", "play", "sharp", "that",
+        "simply", "when", "through", "hello", "bird", "listen", "soft", "mine", "until",
+        "against", "boat", "laugh", "clear", "yours", "once", "above", "fish", "study", "smooth",
+        "his", "seldom", "as", "along", "book", "climb", "funny", "weep", "clearly", "nor",
+        "beside", "chair", "dig", "hard", "whom", "eventually", "therefore", "beneath", "table",
+        "drive", "easy", "myself", "indeed", "instead", "beyond", "music", "cook", "happy",
+        "herself", "recently", "nevertheless", "inside", "window", "smile", "itself", "moreover",
+        "outside", "door", "open", "wide", "ourselves", "finally", "hence", "roof", "close",
+        "short", "anybody", "suddenly", "thus", "across", "wall", "throw", "rough", "somebody",
+        "just", "accordingly", "below", "ground", "hold", "nobody", "maybe", "also", "within",
+        "ceiling", "catch", "narrow", "sometimes", "otherwise", "without", "path", "build",
+        "thick", "everybody", "furthermore", "upon", "street", "draw", "thin", "often",
+        "meanwhile", "alongside", "road", "cut", "heavy", "immediately", "likewise", "underneath",
+        "bridge", "chase", "light", "anything", "always", "anyway", "among", "mountain", "seek",
+        "whichever", "henceforward", "forest", "lift", "themselves", "nonetheless", "throughout",
+        "ocean", "taste", "clean", "whomever", "hardly", "around", "yay"
+};
+
+// Hash of a word in any character type, seeded for the perfect hash below
+template<typename String>
+constexpr auto wordHash(String const& word, std::uint32_t seed = 0) -> std::uint32_t {
+    std::uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (auto c : word) {
+        hash ^= static_cast<std::uint32_t>(c);
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Everything the game needs about a built-in word, computed at compile time
+struct BuiltInWord {
+    std::string_view text;
+    std::string_view key;       // Case-folded text
+    std::u32string_view wideKey;    // The same key in char32_t, the game's words view it instead of copying it
+    std::uint16_t index;
+    std::uint8_t length;
+    std::uint32_t hash;         // wordHash(key)
+};
+
+namespace built_in_words {
+    inline constexpr std::size_t count = std::size(builtInWordTexts);
+    inline constexpr std::size_t slotCount = 512;      // Power of two, at least twice the word count
+    inline constexpr std::size_t bucketCount = 64;
+
+    static_assert(count * 2 <= slotCount && count < 0x8000);
+
+    inline constexpr auto charCount = [] {
+        std::size_t chars = 0;
+        for (auto text : builtInWordTexts)
+            chars += text.size();
+        return chars;
+    }();
+
+    // Folded forms of all words back to back, the keys are views into it
+    inline constexpr auto foldedChars = [] {
+        std::array<char, charCount> chars{};
+        std::size_t position = 0;
+        for (auto text : builtInWordTexts) {
+            for (char c : text)
+                chars[position++] = c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
+        }
+        return chars;
+    }();
+
+    inline constexpr auto foldedWideChars = [] {
+        std::array<char32_t, charCount> chars{};
+        for (std::size_t i = 0; i < charCount; ++i)
+            chars[i] = static_cast<unsigned char>(foldedChars[i]);
+        return chars;
+    }();
+
+    inline constexpr auto isAscii = [] {
+        for (auto text : builtInWordTexts) {
+            for (char c : text) {
+                if (static_cast<unsigned char>(c) >= 0x80) return false;
+            }
+        }
+        return true;
+    }();
+    static_assert(isAscii, "Built-in words are folded as ASCII, the same as foldCase folds them at runtime");
+
+    inline constexpr auto table = [] {
+        std::array<BuiltInWord, count> words{};
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto text = builtInWordTexts[i];
+            std::string_view key(foldedChars.data() + position, text.size());
+            std::u32string_view wideKey(foldedWideChars.data() + position, text.size());
+            words[i] = {text, key, wideKey, static_cast<std::uint16_t>(i), static_cast<std::uint8_t>(text.size()), wordHash(key)};
+            position += text.size();
+        }
+        return words;
+    }();
+
+    // Hash and displace: words are split into buckets by their hash, every bucket gets the first seed
+    // that puts all of its words into free slots, biggest buckets first
+    struct PerfectHash {
+        std::array<std::uint16_t, bucketCount> seeds{};
+        std::array<std::int16_t, slotCount> slots{};
+        bool complete = true;
+    };
+
+    inline constexpr auto perfectHash = [] {
+        PerfectHash result;
+        result.slots.fill(-1);
+
+        std::array<std::size_t, bucketCount + 1> bucketStart{};
+        for (auto const& word : table)
+            bucketStart[word.hash % bucketCount + 1]++;
+        for (std::size_t bucket = 0; bucket < bucketCount; ++bucket)
+            bucketStart[bucket + 1] += bucketStart[bucket];
+
+        std::array<std::uint16_t, count> members{};
+        auto fill = bucketStart;
+        for (auto const& word : table)
+            members[fill[word.hash % bucketCount]++] = word.index;
+
+        std::array<std::size_t, bucketCount> order{};
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+        });
+
+        for (auto bucket : order) {
+            bool placed = false;
+            for (std::uint32_t seed = 1; seed < 0x10000 && !placed; ++seed) {
+                placed = true;
+                auto member = bucketStart[bucket];
+                for (; member < bucketStart[bucket + 1]; ++member) {
+                    auto slot = wordHash(table[members[member]].key, seed) & (slotCount - 1);
+                    if (result.slots[slot] != -1) {
+                        placed = false;
+                        break;
+                    }
+                    result.slots[slot] = static_cast<std::int16_t>(members[member]);
+                }
+                if (!placed) {
+                    while (member-- > bucketStart[bucket])
+                        result.slots[wordHash(table[members[member]].key, seed) & (slotCount - 1)] = -1;
+                } else {
+                    result.seeds[bucket] = static_cast<std::uint16_t>(seed);
+                }
+            }
+            result.complete = result.complete && placed;
+        }
+        return result;
+    }();
+
+    static_assert(perfectHash.complete, "Built-in words must be unique, every word needs its own perfect hash slot");
+}
+
+inline constexpr auto const& builtInWords = built_in_words::table;
+
+// Index of the built-in word with this folded key, -1 when there is none, one hash and one comparison
+template<typename String>
+constexpr auto findBuiltInWord(String const& key) -> int {
+    using namespace built_in_words;
+    auto seed = perfectHash.seeds[wordHash(key) % bucketCount];
+    auto index = perfectHash.slots[wordHash(key, seed) & (slotCount - 1)];
+    if (index < 0)
+        return -1;
+    auto candidate = table[static_cast<std::size_t>(index)].key;
+    return std::equal(candidate.begin(), candidate.end(), key.begin(), key.end()) ? index : -1;
+}
+
+static_assert(findBuiltInWord(std::string_view("apple")) == 0);
+static_assert(findBuiltInWord(std::string_view("yay")) == static_cast<int>(built_in_words::count) - 1);
+static_assert(findBuiltInWord(std::string_view("apples")) == -1);
+static_assert(findBuiltInWord(builtInWords[7].wideKey) == 7);